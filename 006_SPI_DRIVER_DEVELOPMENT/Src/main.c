@@ -20,6 +20,8 @@
 #include <string.h>
 #include "stm32f407xx_gpio.h"
 #include "stm32f407xx_spi.h"
+#include "stm32f407xx_gpio_debounce.h"
+#include "stm32f407xx_rcc.h"
 
 #if !defined(__SOFT_FP__) && defined(__ARM_FP)
   #warning "FPU is not initialized, but the project is compiling for an FPU. Please initialize the FPU before use."
@@ -101,85 +103,284 @@
 //    GPIOB_Handle.GPIO_CONFIG.GPIO_PU_PD      = GPIO_PU_PD_NONE;
 //    gpio_pin_init(&GPIOB_Handle);
 //}
+/** SPI3 pins: PA4 (NSS), PB3 (SCK), PB4 (MISO), PB5 (MOSI), all AF6 */
+#define SPI3_PINS(X, P) \
+    X(P, GPIO_PORT_A, GPIO_PIN_4, GPIO_MODE_ALT_FUNC, GPIO_OP_TYPE_PP, GPIO_SPEED_HIGH, GPIO_PU_PD_PULL_UP, GPIO_ALT_FUNC_6) \
+    X(P, GPIO_PORT_B, GPIO_PIN_3, GPIO_MODE_ALT_FUNC, GPIO_OP_TYPE_PP, GPIO_SPEED_HIGH, GPIO_PU_PD_NONE,    GPIO_ALT_FUNC_6) \
+    X(P, GPIO_PORT_B, GPIO_PIN_4, GPIO_MODE_ALT_FUNC, GPIO_OP_TYPE_PP, GPIO_SPEED_HIGH, GPIO_PU_PD_PULL_UP, GPIO_ALT_FUNC_6) \
+    X(P, GPIO_PORT_B, GPIO_PIN_5, GPIO_MODE_ALT_FUNC, GPIO_OP_TYPE_PP, GPIO_SPEED_HIGH, GPIO_PU_PD_NONE,    GPIO_ALT_FUNC_6)
+
+GPIO_PIN_TABLE_ASSERT(SPI3_PINS)
+
+/** Register images computed by the compiler, kept in flash */
+static const GPIOx_PortImage_t spi3_gpio[] = {
+    GPIO_PORT_IMAGE(SPI3_PINS, GPIO_PORT_A),
+    GPIO_PORT_IMAGE(SPI3_PINS, GPIO_PORT_B),
+};
+
 void GPIO_SPI3_INIT(void)
 {
-    // Using GPIOA pins: PA4 (NSS), PB3 (SCK), PB4 (MISO), PB5 (MOSI)
+    /** One store per register and port, port clocks enabled by the driver */
+    gpio_port_apply_images(spi3_gpio, sizeof(spi3_gpio) / sizeof(spi3_gpio[0]));
+}
 
-    RCC_RegDef_t *pRCC = RCC;
+const static char data[] = "I love you nehudiiiiiiiiiiii.........";
 
-    GPIOx_Handle_t GPIOB_Handle;
-    GPIOB_Handle.pGPIOx = GPIOB;
+/** Shared with the ISRs, the interrupt driven transfer state lives in the handle */
+SPIx_Handle_t SPI_Handle;
 
-    /** 1. Enable GPIOA Peripheral Clock */
-    pRCC->AHB1ENR |= (1U << RCC_AHB1ENR_GPIOB_EN_Pos);
-    pRCC->AHB1ENR |= (1U << RCC_AHB1ENR_GPIOA_EN_Pos);
+/** User button on PA0 */
+static GPIO_DebounceButton_t Button;
 
-    /** Common configuration for all SPI pins */
-    GPIOB_Handle.GPIO_CONFIG.GPIO_MODE      = GPIO_MODE_ALT_FUNC;
-    GPIOB_Handle.GPIO_CONFIG.GPIO_ALT_FUNC  = GPIO_ALT_FUNC_6;
-    GPIOB_Handle.GPIO_CONFIG.GPIO_SPEED     = GPIO_SPEED_HIGH;
-    GPIOB_Handle.GPIO_CONFIG.GPIO_OP_TYPE   = GPIO_OP_TYPE_PP;
+static void spi_event_callback(SPIx_Handle_t *pSPI_Handle, uint8_t AppEvent)
+{
+	if (AppEvent == SPI_EVENT_TX_CMPLT) {
+		/** Waits for BSY=0 on the last frame, then drops SPE (and NSS) */
+		SPIx_Peri_Control(pSPI_Handle->pSPIx, DISABLE);
+	}
+}
 
-    /** 2. PA4 = NSS (AF5, Pull-up recommended) */
-    GPIOB_Handle.pGPIOx = GPIOA;
-    GPIOB_Handle.GPIO_CONFIG.GPIO_PIN_NUMBER = GPIO_PIN_4;
-    GPIOB_Handle.GPIO_CONFIG.GPIO_PU_PD      = GPIO_PU_PD_PULL_UP;
-    gpio_pin_init(&GPIOB_Handle);
+/**
+ * ART accelerator benchmark: a loop of known length run from flash with the
+ * accelerator off and on. Read art_ipc_x100[] with the debugger; IPC x 100.
+ */
+#define ART_BENCH_LOOPS   1000U
+#define ART_BENCH_INSTR   (ART_BENCH_LOOPS * 18U) /** 16 x ADDS + SUBS + BNE per pass */
 
-    GPIOB_Handle.pGPIOx = GPIOB;
-    /** 3. PB3 = SCK (floating, AF5) */
-    GPIOB_Handle.GPIO_CONFIG.GPIO_PIN_NUMBER = GPIO_PIN_3;
-    GPIOB_Handle.GPIO_CONFIG.GPIO_PU_PD      = GPIO_PU_PD_NONE;
-    gpio_pin_init(&GPIOB_Handle);
+volatile uint32_t art_cycles[2];   /** [0] ART off, [1] ART on */
+volatile uint32_t art_ipc_x100[2];
 
-    /** 4. PB4 = MISO (floating is OK, optional pull-up) */
-    GPIOB_Handle.GPIO_CONFIG.GPIO_PIN_NUMBER = GPIO_PIN_4;
-    GPIOB_Handle.GPIO_CONFIG.GPIO_PU_PD      = GPIO_PU_PD_PULL_UP;
-    gpio_pin_init(&GPIOB_Handle);
+static uint32_t art_bench_run(void)
+{
+	uint32_t n = ART_BENCH_LOOPS, acc = 0;
+	uint32_t start = DWT->CYCCNT;
+	__asm volatile (
+		"1:\n\t"
+		".rept 16\n\t"
+		"adds %1, %1, #1\n\t"
+		".endr\n\t"
+		"subs %0, %0, #1\n\t"
+		"bne 1b"
+		: "+l" (n), "+l" (acc) :: "cc");
+	return DWT->CYCCNT - start;
+}
 
-    /** 5. PB5 = MOSI (floating) */
-    GPIOB_Handle.GPIO_CONFIG.GPIO_PIN_NUMBER = GPIO_PIN_5;
-    GPIOB_Handle.GPIO_CONFIG.GPIO_PU_PD      = GPIO_PU_PD_NONE;
-    gpio_pin_init(&GPIOB_Handle);
+/** SysTick stays at 1 ms whatever HCLK is */
+static uint8_t systick_clock_hook(uint8_t Phase, void *pContext)
+{
+	(void)pContext;
+	if (Phase == RCC_CLOCK_CHANGE_POST) {
+		SYSTICK->LOAD = (rcc_get_hclk() / 1000UL) - 1;
+		SYSTICK->VAL = 0;
+	}
+	return RCC_OK;
 }
 
-const static char data[] = "I love you nehudiiiiiiiiiiii.........";
+/**
+ * Driver benchmarks on the DWT cycle counter; read the arrays with the
+ * debugger. Each figure is the fewest cycles of BENCH_RUNS runs, every run
+ * with interrupts masked so no SysTick/EXTI/SPI interrupt lands inside it.
+ */
+#define BENCH_RUNS        8U
+#define SPI_BENCH_LEN     256U
+#define GPIO_BENCH_LOOPS  100U
+#define BENCH_EXTI_LINE   1U    /** No pin or peripheral routed to it here */
+
+volatile uint32_t spi_txrx_cycles[2];   /** SCK = PCLK1/2: [0] SPIx_SendData_Blocking, [1] SPIx_TransmitReceive */
+volatile uint32_t spi_send_bps[8];      /** SPIx_SendData_Blocking bytes per second at BR = 0..7 */
+volatile uint32_t gpio_cycles[3];       /** PD12 set + clear: [0] ODR |= / &=, [1] BSRR stores, [2] gpio_write_pin() */
+volatile uint32_t bitband_cycles[2];    /** EXTI IMR set + clear: [0] |= / &=, [1] bit-band alias */
+
+static uint8_t spi_bench_tx[SPI_BENCH_LEN];
+static uint8_t spi_bench_rx[SPI_BENCH_LEN];
+
+static uint32_t bench_min(uint32_t (*pfRun)(void))
+{
+	uint32_t best = UINT32_MAX;
+	for (uint32_t i = 0; i < BENCH_RUNS; i++) {
+		uint32_t primask = nvic_irq_save();
+		uint32_t cycles = pfRun();
+		nvic_irq_restore(primask);
+		if (cycles < best) {
+			best = cycles;
+		}
+	}
+	return best;
+}
+
+/** SPE is cleared for the BR write, the caller enables SPI3 again */
+static void spi_bench_set_br(uint8_t br)
+{
+	SPIx_Peri_Control(SPI3, DISABLE);
+	SPI3->CR1 = (SPI3->CR1 & ~(0x7U << SPI_CR1_BR_Pos)) | ((uint32_t)br << SPI_CR1_BR_Pos);
+}
+
+static uint32_t spi_bench_send(void)
+{
+	uint32_t start = DWT->CYCCNT;
+	SPIx_SendData_Blocking(SPI3, spi_bench_tx, SPI_BENCH_LEN); /** Returns on BSY=0 */
+	uint32_t cycles = DWT->CYCCNT - start;
+	/** The send-only loop leaves RXNE and OVR behind */
+	(void)SPI3->DR;
+	(void)SPI3->SR;
+	return cycles;
+}
+
+static uint32_t spi_bench_txrx(void)
+{
+	uint32_t start = DWT->CYCCNT;
+	SPIx_TransmitReceive(&SPI_Handle, spi_bench_tx, spi_bench_rx, SPI_BENCH_LEN);
+	return DWT->CYCCNT - start;
+}
+
+static uint32_t gpio_bench_odr(void)
+{
+	uint32_t start = DWT->CYCCNT;
+	for (uint32_t i = 0; i < GPIO_BENCH_LOOPS; i++) {
+		GPIOD->ODR |= (1U << GPIO_PIN_12);
+		GPIOD->ODR &= ~(1U << GPIO_PIN_12);
+	}
+	return DWT->CYCCNT - start;
+}
+
+static uint32_t gpio_bench_bsrr(void)
+{
+	uint32_t start = DWT->CYCCNT;
+	for (uint32_t i = 0; i < GPIO_BENCH_LOOPS; i++) {
+		GPIOD->BSRR = (1U << GPIO_PIN_12);
+		GPIOD->BSRR = (1U << (GPIO_PIN_12 + 16));
+	}
+	return DWT->CYCCNT - start;
+}
+
+static uint32_t gpio_bench_api(void)
+{
+	uint32_t start = DWT->CYCCNT;
+	for (uint32_t i = 0; i < GPIO_BENCH_LOOPS; i++) {
+		gpio_write_pin(GPIOD, GPIO_PIN_12, SET);
+		gpio_write_pin(GPIOD, GPIO_PIN_12, RESET);
+	}
+	return DWT->CYCCNT - start;
+}
+
+static uint32_t bitband_bench_rmw(void)
+{
+	uint32_t start = DWT->CYCCNT;
+	for (uint32_t i = 0; i < GPIO_BENCH_LOOPS; i++) {
+		EXTI->IMR |= (1U << BENCH_EXTI_LINE);
+		EXTI->IMR &= ~(1U << BENCH_EXTI_LINE);
+	}
+	return DWT->CYCCNT - start;
+}
+
+static uint32_t bitband_bench_alias(void)
+{
+	uint32_t start = DWT->CYCCNT;
+	for (uint32_t i = 0; i < GPIO_BENCH_LOOPS; i++) {
+		BITBAND_PERIPH(EXTI->IMR, BENCH_EXTI_LINE) = 1U;
+		BITBAND_PERIPH(EXTI->IMR, BENCH_EXTI_LINE) = 0U;
+	}
+	return DWT->CYCCNT - start;
+}
 
 int main(void)
 {
-	/** 0. Set PA0 as input button */
+	/** 0. 168 MHz from the 8 MHz HSE: VCO 336 MHz, 48 MHz for USB, APB1 42 MHz, APB2 84 MHz */
+		uint8_t preset = RCC_PRESET_168MHZ;
+		rcc_set_preset(preset); /** Stays on HSI 16 MHz if the crystal fails */
+	/** 0.1 Flash wait states without and with prefetch + I/D caches */
+		COREDEBUG->DEMCR |= (1U << COREDEBUG_DEMCR_TRCENA_Pos);
+		DWT->CTRL |= (1U << DWT_CTRL_CYCCNTENA_Pos);
+		flash_art_config(0);
+		art_cycles[0] = art_bench_run();
+		flash_art_config(FLASH_ART_ALL);
+		art_cycles[1] = art_bench_run();
+		art_ipc_x100[0] = (ART_BENCH_INSTR * 100U) / art_cycles[0];
+		art_ipc_x100[1] = (ART_BENCH_INSTR * 100U) / art_cycles[1];
+	/** 0.2 Set PA0 as input button, debounced from a 1 ms SysTick */
 		GPIOx_Handle_t GPIOA_Handle;
 		memset(&GPIOA_Handle,0,sizeof(GPIOA_Handle));
 		GPIOA_Handle.pGPIOx = GPIOA;
 		GPIOA_Handle.GPIO_CONFIG.GPIO_MODE = GPIO_MODE_INPUT;
 		GPIOA_Handle.GPIO_CONFIG.GPIO_PIN_NUMBER = GPIO_PIN_0;
 		gpio_pin_init(&GPIOA_Handle);
-		gpio_irq_config(GPIOA, GPIO_PIN_0, INTERRUPT_TRIGGER_TYPE_RISING, 0);
-		gpio_irq_control(GPIO_PIN_0, ENABLE);
+		Button.pGPIOx = GPIOA;
+		Button.Pin = GPIO_PIN_0;
+		Button.ActiveLevel = SET;
+		Button.IrqPriority = NVIC_IRQ_PRIORITY_0;
+		gpio_debounce_init(&Button);
+		SYSTICK->LOAD = (rcc_get_hclk() / 1000UL) - 1;
+		SYSTICK->VAL = 0;
+		SYSTICK->CTRL = (1U << SYSTICK_CTRL_CLKSOURCE_Pos) | (1U << SYSTICK_CTRL_TICKINT_Pos)
+				| (1U << SYSTICK_CTRL_ENABLE_Pos);
+		rcc_clock_hook_register(systick_clock_hook, NULL);
 	/** 1. Enabling the GPIO for SPI1 Alternate Functionality */
 //		GPIO_SPI1_INIT();
 //		GPIO_SPI2_INIT();
 		GPIO_SPI3_INIT();
 	/** 2. Configure SPI1 */
-		SPIx_Handle_t SPI_Handle;
 		memset(&SPI_Handle,0,sizeof(SPI_Handle));
 		//SPI_Handle.pSPIx = SPI1;
 //		SPI_Handle.pSPIx = SPI2;
 		SPI_Handle.pSPIx = SPI3;
 		SPI_Handle.SPI_CONFIG.SPI_DEVICE_MODE = SPI_DEVICE_MODE_MASTER;
-		SPI_Handle.SPI_CONFIG.SPI_CLOCK_SPEED = SPI_CLOCK_SPEED_BY_16;
+		SPI_Handle.SPI_CONFIG.SPI_CLOCK_SPEED = SPIx_ComputeClockSpeed(SPI3, 1000000UL); /** <= 1 MHz at any PCLK1 */
 		SPI_Handle.SPI_CONFIG.SPI_BUS_MODE = SPI_BUS_MODE_FULL_DUPLEX;
 		SPI_Handle.SPI_CONFIG.SPI_CPOL = SPI_CPOL_LOW;
 		SPI_Handle.SPI_CONFIG.SPI_CPHA = SPI_CPHA_FIRST_EDGE;
 		SPI_Handle.SPI_CONFIG.SPI_BIT_ORDER = SPI_BIT_ORDER_MSB_FIRST;
 		SPI_Handle.SPI_CONFIG.SPI_FRAME_SIZE = SPI_FRAME_SIZE_8_BITS;
 		SPI_Handle.SPI_CONFIG.SPI_SSOE = SPI_SSOE_EN;
+		SPI_Handle.AppEventCallback = spi_event_callback;
 		SPIx_Init(&SPI_Handle);
+	/** 2.1 Driver benchmarks, results in the arrays above main() */
+		for (uint32_t i = 0; i < SPI_BENCH_LEN; i++) {
+			spi_bench_tx[i] = (uint8_t)i;
+		}
+		spi_bench_set_br(SPI_CLOCK_SPEED_BY_2);
+		SPIx_Peri_Control(SPI3, ENABLE);
+		spi_txrx_cycles[0] = bench_min(spi_bench_send);
+		spi_txrx_cycles[1] = bench_min(spi_bench_txrx);
+		for (uint8_t br = 0; br < 8; br++) {
+			spi_bench_set_br(br);
+			SPIx_Peri_Control(SPI3, ENABLE);
+			spi_send_bps[br] = (uint32_t)(((uint64_t)SPI_BENCH_LEN * rcc_get_hclk()) / bench_min(spi_bench_send));
+		}
+		spi_bench_set_br(SPI_Handle.SPI_CONFIG.SPI_CLOCK_SPEED);
+		GPIOx_Handle_t GPIOD_Handle;
+		memset(&GPIOD_Handle,0,sizeof(GPIOD_Handle));
+		GPIOD_Handle.pGPIOx = GPIOD;
+		GPIOD_Handle.GPIO_CONFIG.GPIO_MODE = GPIO_MODE_OUTPUT;
+		GPIOD_Handle.GPIO_CONFIG.GPIO_PIN_NUMBER = GPIO_PIN_12;
+		gpio_pin_init(&GPIOD_Handle);
+		gpio_cycles[0] = bench_min(gpio_bench_odr);
+		gpio_cycles[1] = bench_min(gpio_bench_bsrr);
+		gpio_cycles[2] = bench_min(gpio_bench_api);
+		bitband_cycles[0] = bench_min(bitband_bench_rmw);
+		bitband_cycles[1] = bench_min(bitband_bench_alias);
+		SPIx_RegisterClockHook(&SPI_Handle, 1000000UL); /** Keeps SCK <= 1 MHz at every preset */
+		SPIx_IRQ_Config(IRQ_NUM_SPI3, NVIC_IRQ_PRIORITY_1);
+		SPIx_IRQ_Control(IRQ_NUM_SPI3, ENABLE);
 //	/** 2. Enable SPI1 */
 //		SPIx_Peri_Control(SPI_Handle.pSPIx, ENABLE);
 	/** 3. Send Data */
 
 		while(1){
+			GPIO_DebounceEvent_t event;
+			while (gpio_debounce_get_event(&event)) {
+				if (event.Event == GPIO_DEBOUNCE_EVENT_PRESS && SPI_Handle.TxState == SPI_STATE_READY) {
+					SPIx_Peri_Control(SPI3, ENABLE);
+					/** Returns at once, SPI3_IRQHandler feeds DR and the callback disables SPI */
+					SPIx_SendData_IT(&SPI_Handle, (const uint8_t*)data, sizeof(data));
+				}
+				if (event.Event == GPIO_DEBOUNCE_EVENT_LONG_PRESS) {
+					/** 168 -> 84 -> 16 -> 168 MHz; refused while SPI3 sends, the hooks retune SysTick/SPI3 */
+					uint8_t next = (uint8_t)((preset + 1U) % RCC_PRESET_COUNT);
+					if (rcc_set_preset(next) == RCC_OK) {
+						preset = next;
+					}
+				}
+			}
 //			if(gpio_read_pin(GPIOA, GPIO_PIN_0)){
 //				for(int i = 0;i<50000;i++);
 //				SPIx_Peri_Control(SPI_Handle.pSPIx, ENABLE);
@@ -196,25 +397,14 @@ int main(void)
 }
 
 void EXTI0_IRQHandler(void){
-	//gpio_irq_clear(GPIO_PIN_0);
-	gpio_irq_control(GPIO_PIN_0, DISABLE);
-	for(volatile int i = 0;i<15000;i++);
-//	SPIx_Peri_Control(SPI1, ENABLE);
-//	SPIx_Peri_Control(SPI2, ENABLE);
-	SPIx_Peri_Control(SPI3, ENABLE);
-	SPIx_SendData_Blocking(SPI3, (uint8_t*)data, sizeof(data));
-//	SPIx_Peri_Control(SPI1, DISABLE);
-	//SPIx_Peri_Control(SPI2, DISABLE);
-	SPIx_Peri_Control(SPI3, DISABLE);
-	while(gpio_read_pin(GPIOA, GPIO_PIN_0));
-	for(volatile int i = 0;i<15000;i++);
-	gpio_irq_control(GPIO_PIN_0, ENABLE);
+	/** Masks the line and returns, the bounce is filtered from SysTick */
+	gpio_exti_dispatch(1U << GPIO_PIN_0);
 }
 
+void SysTick_Handler(void){
+	gpio_debounce_tick();
+}
 
-
-
-
-
-
-
+void SPI3_IRQHandler(void){
+	SPIx_IRQHandling(&SPI_Handle);
+}
@@ -11,6 +11,7 @@
 #ifndef INC_STM32F407XX_H_
 #define INC_STM32F407XX_H_
 #include<stdint.h>
+#include<stddef.h>
 
 /**
  * @defgroup MISCELLANEOUS_MACROS General-purpose macros
@@ -23,6 +24,37 @@
 #define SET      1
 #define RESET    0
 
+/**
+ * @brief Compiler barrier: memory accesses are not moved across it.
+ * @note  Enough for single-core producer/consumer rings shared with an ISR;
+ *        the Cortex-M4 does not reorder normal memory stores.
+ */
+#define COMPILER_BARRIER()   __asm volatile ("" ::: "memory")
+
+/**
+ * @brief Place a function in SRAM (.RamFunc, copied with .data by the startup code).
+ *
+ * Code runs from SRAM1 over the S-bus with no flash wait states or ART misses.
+ * Calls between flash and SRAM go through linker generated long-branch veneers.
+ * @note  CCM RAM is only on the D-bus of the F407, it cannot execute code;
+ *        .ccmram is for data only (and is not initialised by the startup code).
+ */
+#define RAMFUNC  __attribute__((section(".RamFunc"), noinline))
+
+/**
+ * @brief Move the driver interrupt paths (EXTI dispatch, SPI IRQ handling) to SRAM.
+ * @note  Can be overridden from the compiler command line.
+ */
+#ifndef ISR_IN_RAM_EN
+#define ISR_IN_RAM_EN   0
+#endif
+
+#if ISR_IN_RAM_EN
+#define ISR_RAMFUNC  RAMFUNC
+#else
+#define ISR_RAMFUNC
+#endif
+
 /** @} */  // end of MISCELLANEOUS_MACROS
 
 /**
@@ -50,6 +82,43 @@
 #define AHB2_PERIPHERAL_BASEADDR 	0x50000000UL /**< AHB2 Peripheral base address */
 /** @} */
 
+/**
+ * @defgroup BITBAND_MACROS Bit-Band Alias Macros
+ * @brief Single-bit access to the peripheral region through its bit-band alias.
+ *
+ * Every bit of 0x40000000..0x400FFFFF (APB1, APB2 and AHB1 up to RCC/DMA, so
+ * GPIO, EXTI, SPI, SYSCFG) has its own word at 0x42000000 + offset*32 + bit*4.
+ * Writing 0/1 there changes only that bit with one store; the bus does the
+ * read-modify-write, so no ISR can interleave. AHB2 and the Cortex-M4 core
+ * registers (NVIC, SCB, ...) are outside the region.
+ *
+ * BITBAND_EN = 0 makes PERIPH_BIT_SET/PERIPH_BIT_CLR fall back to |= / &=.
+ * @{
+ */
+#ifndef BITBAND_EN
+#define BITBAND_EN  1
+#endif
+
+#define PERIPH_BB_BASEADDR   0x42000000UL   /**< Alias of PERIPHERAL_BASEADDR */
+#define SRAM_BB_BASEADDR     0x22000000UL   /**< Alias of SRAM1_BASEADDR      */
+
+/** Alias word of bit BIT of peripheral register REG (an lvalue, e.g. EXTI->IMR) */
+#define BITBAND_PERIPH(REG, BIT)  (*(volatile uint32_t*)(PERIPH_BB_BASEADDR \
+                                   + (((uint32_t)(uintptr_t)&(REG) - PERIPHERAL_BASEADDR) << 5) + ((uint32_t)(BIT) << 2)))
+
+/** Alias word of bit BIT of a variable in SRAM1/SRAM2 */
+#define BITBAND_SRAM(VAR, BIT)    (*(volatile uint32_t*)(SRAM_BB_BASEADDR \
+                                   + (((uint32_t)(uintptr_t)&(VAR) - SRAM1_BASEADDR) << 5) + ((uint32_t)(BIT) << 2)))
+
+#if BITBAND_EN
+#define PERIPH_BIT_SET(REG, BIT)  (BITBAND_PERIPH(REG, BIT) = 1U)
+#define PERIPH_BIT_CLR(REG, BIT)  (BITBAND_PERIPH(REG, BIT) = 0U)
+#else
+#define PERIPH_BIT_SET(REG, BIT)  ((REG) |= (1U << (BIT)))
+#define PERIPH_BIT_CLR(REG, BIT)  ((REG) &= ~(1U << (BIT)))
+#endif
+/** @} */   // end of BITBAND_MACROS
+
 
 /**
  * @defgroup AHB1_PERIPEHRALS_BASE_ADDRESSES Base address of AHB1 peripherals
@@ -239,7 +308,7 @@ typedef struct {
 	volatile uint32_t IDR;       /*!< @todo Add Explanation*/
 	volatile uint32_t ODR;       /*!< @todo Add Explanation*/
 	volatile uint32_t BSRR;      /*!< @todo Add Explanation*/
-	volatile uint32_t LCKR;      /*!< @todo Add Explanation*/
+	volatile uint32_t LCKR;      /*!< Configuration lock, key sequence on LCKK (bit 16), OFFSET: 0x1C*/
 	volatile uint32_t AFRL;      /*!< @todo Add Explanation*/
 	volatile uint32_t AFRH;      /*!< @todo Add Explanation*/
 }GPIOx_RegDef_t;
@@ -265,6 +334,30 @@ typedef struct {
 
 /** @} */   /* End of GPIO_BASE_ADDRESSES */
 
+/**
+ * @defgroup GPIO_PORT_INDEX_MACROS GPIO Port Index Macros
+ * @brief Port index A=0 .. I=8 computed from the port address.
+ *
+ * The ports are 0x400 apart from GPIOA_BASEADDR, so one subtract and one
+ * shift replace a compare chain. The same index is the port code of
+ * SYSCFG_EXTICR and the GPIOx bit of RCC AHB1ENR/AHB1RSTR.
+ * @{
+ */
+#define GPIO_PORT_COUNT          9U   /*!< GPIOA..GPIOI */
+#define GPIO_PORT_A              0U   /*!< Port indices, usable in constant expressions */
+#define GPIO_PORT_B              1U
+#define GPIO_PORT_C              2U
+#define GPIO_PORT_D              3U
+#define GPIO_PORT_E              4U
+#define GPIO_PORT_F              5U
+#define GPIO_PORT_G              6U
+#define GPIO_PORT_H              7U
+#define GPIO_PORT_I              8U
+#define GPIO_PORT_INDEX(pGPIOx)  ((uint32_t)(((uintptr_t)(pGPIOx) - GPIOA_BASEADDR) >> 10))
+#define GPIO_PORT_FROM_INDEX(i)  ((GPIOx_RegDef_t*)(GPIOA_BASEADDR + ((uint32_t)(i) << 10)))
+#define GPIO_PORT_RCC_ID(i)      RCC_PERIPH_ID(RCC_BUS_AHB1, (i))   /*!< @ref RCC_PERIPH_ID_MACROS */
+/** @} */   /* End of GPIO_PORT_INDEX_MACROS */
+
 
 
 
@@ -313,6 +406,35 @@ typedef struct {
 
 /** @} */
 
+/**
+ * @defgroup FLASH_IF_REG Flash Interface Register Definition
+ * @brief Embedded flash interface (access control, program/erase), not the memory itself.
+ * @{
+ */
+typedef struct {
+	volatile uint32_t ACR;     /*!< Access control (latency, prefetch, caches), OFFSET: 0x00 */
+	volatile uint32_t KEYR;    /*!< Key, OFFSET: 0x04 */
+	volatile uint32_t OPTKEYR; /*!< Option key, OFFSET: 0x08 */
+	volatile uint32_t SR;      /*!< Status, OFFSET: 0x0C */
+	volatile uint32_t CR;      /*!< Control, OFFSET: 0x10 */
+	volatile uint32_t OPTCR;   /*!< Option control, OFFSET: 0x14 */
+} FLASH_IF_RegDef_t;
+
+#define FLASH_IF   ((FLASH_IF_RegDef_t*)FLASH_IF_REG_BASEADDR)
+/** @} */
+
+/**
+ * @defgroup PWR_REG PWR Register Definition
+ * @{
+ */
+typedef struct {
+	volatile uint32_t CR;      /*!< Power control (VOS, PVD, backup access), OFFSET: 0x00 */
+	volatile uint32_t CSR;     /*!< Power control/status, OFFSET: 0x04 */
+} PWR_RegDef_t;
+
+#define PWR   ((PWR_RegDef_t*)PWR_BASEADDR)
+/** @} */
+
 /**@defgroup SYSCFG_REG SYSCFG Peripheral Register Definition
  * @brief Register Definition of System Configuration and Controller (SYSCFG) Peripheral Register
  * @{
@@ -320,10 +442,8 @@ typedef struct {
 typedef struct  {
 	volatile uint32_t MEMRMP;	 		  	/*!< @todo Add Explanation OFFSET: 0x00 */
 	volatile uint32_t PMC;	 		  		/*!< @todo Add Explanation OFFSET: 0x04 */
-	volatile uint32_t EXTICR1;	 		  	/*!< @todo Add Explanation OFFSET: 0x08 */
-	volatile uint32_t EXTICR2;	 		  	/*!< @todo Add Explanation OFFSET: 0x0C */
-	volatile uint32_t EXTICR3;	 		  	/*!< @todo Add Explanation OFFSET: 0x10 */
-	volatile uint32_t EXTICR4;	 		  	/*!< @todo Add Explanation OFFSET: 0x14 */
+	volatile uint32_t EXTICR[4];	 		/*!< EXTI line source port, 4 bits per line,
+	                                 		     EXTICR[line / 4] OFFSET: 0x08..0x14 */
 	volatile uint32_t reserved1;	 		  	/*!< @todo Add Explanation OFFSET: 0x18 */
 	volatile uint32_t reserved2;	 		  	/*!< @todo Add Explanation OFFSET: 0x1C */
 	volatile uint32_t CMPCR;	 		  	/*!< @todo Add Explanation OFFSET: 0x20 */
@@ -410,6 +530,12 @@ typedef struct
 	#define GPIOI_PCLK_EN() (RCC->AHB1ENR |= (1<<8))  /*!< Enable GPIOI clock (AHB1ENR bit 8) */
 	#define GPIOI_PCLK_DI() (RCC->AHB1ENR &= ~(1<<8)) /*!< Disable GPIOI clock (AHB1ENR bit 8) */
 
+	#define DMA1_PCLK_EN()  (RCC->AHB1ENR |= (1<<21))  /*!< Enable DMA1 clock (AHB1ENR bit 21) */
+	#define DMA1_PCLK_DI()  (RCC->AHB1ENR &= ~(1<<21)) /*!< Disable DMA1 clock (AHB1ENR bit 21) */
+
+	#define DMA2_PCLK_EN()  (RCC->AHB1ENR |= (1<<22))  /*!< Enable DMA2 clock (AHB1ENR bit 22) */
+	#define DMA2_PCLK_DI()  (RCC->AHB1ENR &= ~(1<<22)) /*!< Disable DMA2 clock (AHB1ENR bit 22) */
+
 		/** @todo Complete for other peripherals */
 
 	/** @} */ // End of AHB1 Bus Peripheral Enable Disable
@@ -547,6 +673,31 @@ typedef struct
 
 /** @} */
 
+/**
+ * @defgroup RCC_PERIPH_ID_MACROS Table Driven Peripheral Clock/Reset Macros
+ * @brief One byte identifies the clock/reset bit of any peripheral.
+ *
+ * The RCC keeps AHB1/AHB2/AHB3/-/APB1/APB2 in the same order for the ENR and
+ * RSTR register rows, so the bus selects the word and the bit the position:
+ * drivers store an id per instance in a table and need no per-instance code.
+ * @{
+ */
+	#define RCC_BUS_AHB1   0U  /*!< AHB1ENR / AHB1RSTR */
+	#define RCC_BUS_AHB2   1U  /*!< AHB2ENR / AHB2RSTR */
+	#define RCC_BUS_AHB3   2U  /*!< AHB3ENR / AHB3RSTR */
+	#define RCC_BUS_APB1   4U  /*!< APB1ENR / APB1RSTR */
+	#define RCC_BUS_APB2   5U  /*!< APB2ENR / APB2RSTR */
+
+	#define RCC_PERIPH_ID(BUS, BIT)   ((uint8_t)(((BUS) << 5) | (BIT)))                    /*!< Build an id         */
+	#define RCC_PERIPH_ENR(ID)        ((&RCC->AHB1ENR)[(ID) >> 5])                         /*!< ENR word of an id   */
+	#define RCC_PERIPH_RSTR(ID)       ((&RCC->AHB1RSTR)[(ID) >> 5])                        /*!< RSTR word of an id  */
+	#define RCC_PERIPH_MASK(ID)       (1UL << ((ID) & 0x1FU))                              /*!< Bit mask of an id   */
+	#define RCC_PERIPH_CLK_EN(ID)     (RCC_PERIPH_ENR(ID) |= RCC_PERIPH_MASK(ID))          /*!< Enable the clock    */
+	#define RCC_PERIPH_CLK_DI(ID)     (RCC_PERIPH_ENR(ID) &= ~RCC_PERIPH_MASK(ID))         /*!< Disable the clock   */
+	#define RCC_PERIPH_RESET(ID)      do{ RCC_PERIPH_RSTR(ID) |= RCC_PERIPH_MASK(ID); \
+	                                      RCC_PERIPH_RSTR(ID) &= ~RCC_PERIPH_MASK(ID); }while(0) /*!< Pulse the reset */
+/** @} */ // end of RCC_PERIPH_ID_MACROS
+
 
 
 /**
@@ -585,6 +736,99 @@ NVIC_RegDef_t{
 /* NVIC pointer */
 #define NVIC   ((NVIC_RegDef_t*)NVIC_BASEADDR)
 
+/* Priority bits implemented per IPR byte on STM32F4, bits [7:4] */
+#define NVIC_PRIO_BITS    4U
+
+/** @} */
+
+/**
+ * @defgroup SCB_REG SCB Register Definition
+ * @brief Cortex-M4 System Control Block.
+ * @{
+ */
+#define SCB_BASEADDR      (0xE000ED00UL)
+
+typedef struct {
+    volatile uint32_t CPUID;       /*!< CPU ID base, OFFSET: 0x00 */
+    volatile uint32_t ICSR;        /*!< Interrupt control and state, OFFSET: 0x04 */
+    volatile uint32_t VTOR;        /*!< Vector table offset, OFFSET: 0x08 */
+    volatile uint32_t AIRCR;       /*!< Application interrupt and reset control, OFFSET: 0x0C */
+    volatile uint32_t SCR;         /*!< System control, OFFSET: 0x10 */
+    volatile uint32_t CCR;         /*!< Configuration and control, OFFSET: 0x14 */
+    volatile uint8_t  SHPR[12];    /*!< System handler priority, exceptions 4..15, OFFSET: 0x18 */
+    volatile uint32_t SHCSR;       /*!< System handler control and state, OFFSET: 0x24 */
+    volatile uint32_t CFSR;        /*!< Configurable fault status, OFFSET: 0x28 */
+    volatile uint32_t HFSR;        /*!< HardFault status, OFFSET: 0x2C */
+    volatile uint32_t DFSR;        /*!< Debug fault status, OFFSET: 0x30 */
+    volatile uint32_t MMFAR;       /*!< MemManage fault address, OFFSET: 0x34 */
+    volatile uint32_t BFAR;        /*!< BusFault address, OFFSET: 0x38 */
+    volatile uint32_t AFSR;        /*!< Auxiliary fault status, OFFSET: 0x3C */
+} SCB_RegDef_t;
+
+#define SCB   ((SCB_RegDef_t*)SCB_BASEADDR)
+
+#define SCB_AIRCR_VECTKEY          0x05FAUL   /*!< Write key, bits [31:16] */
+#define SCB_AIRCR_VECTKEY_Pos      16U
+#define SCB_AIRCR_PRIGROUP_Pos     8U         /*!< 3 bits */
+#define SCB_AIRCR_SYSRESETREQ_Pos  2U
+/** @} */
+
+/**
+ * @defgroup SYSTICK_REG SysTick Register Definition
+ * @brief Cortex-M4 24-bit system timer, used as the periodic tick.
+ * @{
+ */
+#define SYSTICK_BASEADDR  (0xE000E010UL)
+
+typedef struct {
+    volatile uint32_t CTRL;        /*!< Control and status, OFFSET: 0x00 */
+    volatile uint32_t LOAD;        /*!< Reload value (24 bits), OFFSET: 0x04 */
+    volatile uint32_t VAL;         /*!< Current value, OFFSET: 0x08 */
+    volatile uint32_t CALIB;       /*!< Calibration value, OFFSET: 0x0C */
+} SysTick_RegDef_t;
+
+#define SYSTICK   ((SysTick_RegDef_t*)SYSTICK_BASEADDR)
+
+#define SYSTICK_CTRL_ENABLE_Pos     0U   /*!< Counter enable                  */
+#define SYSTICK_CTRL_TICKINT_Pos    1U   /*!< SysTick exception on reaching 0 */
+#define SYSTICK_CTRL_CLKSOURCE_Pos  2U   /*!< 1 = processor clock (HCLK)      */
+#define SYSTICK_CTRL_COUNTFLAG_Pos  16U  /*!< Counted to 0 since last read    */
+/** @} */
+
+/**
+ * @defgroup DWT_REG DWT / CoreDebug Register Definition
+ * @brief Data Watchpoint and Trace unit, used for its free-running cycle counter.
+ *
+ * CYCCNT counts HCLK cycles once DEMCR.TRCENA and DWT_CTRL.CYCCNTENA are set,
+ * wrapping every 2^32 cycles (about 25 s at 168 MHz).
+ * @{
+ */
+#define DWT_BASEADDR        (0xE0001000UL)
+#define COREDEBUG_BASEADDR  (0xE000EDF0UL)
+
+typedef struct {
+    volatile uint32_t CTRL;        /*!< Control, OFFSET: 0x00 */
+    volatile uint32_t CYCCNT;      /*!< Cycle count, OFFSET: 0x04 */
+    volatile uint32_t CPICNT;      /*!< CPI count, OFFSET: 0x08 */
+    volatile uint32_t EXCCNT;      /*!< Exception overhead count, OFFSET: 0x0C */
+    volatile uint32_t SLEEPCNT;    /*!< Sleep count, OFFSET: 0x10 */
+    volatile uint32_t LSUCNT;      /*!< LSU count, OFFSET: 0x14 */
+    volatile uint32_t FOLDCNT;     /*!< Folded instruction count, OFFSET: 0x18 */
+    volatile uint32_t PCSR;        /*!< Program counter sample, OFFSET: 0x1C */
+} DWT_RegDef_t;
+
+typedef struct {
+    volatile uint32_t DHCSR;       /*!< Debug halting control and status, OFFSET: 0x00 */
+    volatile uint32_t DCRSR;       /*!< Debug core register selector, OFFSET: 0x04 */
+    volatile uint32_t DCRDR;       /*!< Debug core register data, OFFSET: 0x08 */
+    volatile uint32_t DEMCR;       /*!< Debug exception and monitor control, OFFSET: 0x0C */
+} CoreDebug_RegDef_t;
+
+#define DWT         ((DWT_RegDef_t*)DWT_BASEADDR)
+#define COREDEBUG   ((CoreDebug_RegDef_t*)COREDEBUG_BASEADDR)
+
+#define DWT_CTRL_CYCCNTENA_Pos      0U   /*!< Cycle counter enable            */
+#define COREDEBUG_DEMCR_TRCENA_Pos  24U  /*!< Enables DWT/ITM                 */
 /** @} */
 
 /**
@@ -744,6 +988,42 @@ typedef struct
 
 /** @} */ // end of SPI_Instances
 
+//==================================================================================//
+//=========================DMA Controller ==========================================//
+//==================================================================================//
+
+/**
+ * @defgroup DMA_REG DMA Register Definition
+ * @brief Register definitions for the DMA1/DMA2 controllers.
+ * @note  Refer RM0090 (DMA controller) for register details
+ * @{
+ */
+
+/** One of the 8 streams of a DMA controller, 0x18 bytes apart starting at 0x10 */
+typedef struct
+{
+    volatile uint32_t CR;       /*!< Stream configuration register     | Offset: 0x00 */
+    volatile uint32_t NDTR;     /*!< Stream number of data register    | Offset: 0x04 */
+    volatile uint32_t PAR;      /*!< Stream peripheral address         | Offset: 0x08 */
+    volatile uint32_t M0AR;     /*!< Stream memory 0 address           | Offset: 0x0C */
+    volatile uint32_t M1AR;     /*!< Stream memory 1 address           | Offset: 0x10 */
+    volatile uint32_t FCR;      /*!< Stream FIFO control register      | Offset: 0x14 */
+} DMA_Stream_RegDef_t;
+
+typedef struct
+{
+    volatile uint32_t LISR;     /*!< Low interrupt status (stream 0..3)    | Offset: 0x00 */
+    volatile uint32_t HISR;     /*!< High interrupt status (stream 4..7)   | Offset: 0x04 */
+    volatile uint32_t LIFCR;    /*!< Low interrupt flag clear              | Offset: 0x08 */
+    volatile uint32_t HIFCR;    /*!< High interrupt flag clear             | Offset: 0x0C */
+    DMA_Stream_RegDef_t STREAM[8]; /*!< Stream 0..7                       | Offset: 0x10 */
+} DMA_RegDef_t;
+
+#define DMA1   ((DMA_RegDef_t*)DMA1_BASEADDR)   /*!< DMA1 base address */
+#define DMA2   ((DMA_RegDef_t*)DMA2_BASEADDR)   /*!< DMA2 base address */
+
+/** @} */ // end of DMA_REG
+
 /**
  * @defgroup RCC_AHB1ENR_BIT_POS RCC AHB1ENR Bit Positions
  * @brief Bit positions for RCC AHB1ENR register.
@@ -777,6 +1057,57 @@ typedef struct
 
 /** @} */ // end of RCC_AHB1ENR_BIT_POS
 
+/**
+ * @defgroup RCC_CR_BIT_POS RCC CR Bit Positions
+ * @{
+ */
+#define RCC_CR_HSION_Pos        0U   /*!< HSI enable */
+#define RCC_CR_HSIRDY_Pos       1U   /*!< HSI ready */
+#define RCC_CR_HSEON_Pos        16U  /*!< HSE enable */
+#define RCC_CR_HSERDY_Pos       17U  /*!< HSE ready */
+#define RCC_CR_HSEBYP_Pos       18U  /*!< HSE bypass (external clock instead of crystal) */
+#define RCC_CR_PLLON_Pos        24U  /*!< Main PLL enable */
+#define RCC_CR_PLLRDY_Pos       25U  /*!< Main PLL locked */
+/** @} */ // end of RCC_CR_BIT_POS
+
+/**
+ * @defgroup RCC_PLLCFGR_BIT_POS RCC PLLCFGR Bit Positions
+ * @{
+ */
+#define RCC_PLLCFGR_PLLM_Pos    0U   /*!< 6 bits, VCO input divider 2..63 */
+#define RCC_PLLCFGR_PLLN_Pos    6U   /*!< 9 bits, VCO multiplier 50..432 */
+#define RCC_PLLCFGR_PLLP_Pos    16U  /*!< 2 bits, SYSCLK divider 2/4/6/8 */
+#define RCC_PLLCFGR_PLLSRC_Pos  22U  /*!< 0: HSI, 1: HSE */
+#define RCC_PLLCFGR_PLLQ_Pos    24U  /*!< 4 bits, USB/SDIO/RNG divider 2..15 */
+/** @} */ // end of RCC_PLLCFGR_BIT_POS
+
+/**
+ * @defgroup RCC_CFGR_BIT_POS RCC CFGR Bit Positions
+ * @{
+ */
+#define RCC_CFGR_SW_Pos         0U   /*!< 2 bits, system clock switch */
+#define RCC_CFGR_SWS_Pos        2U   /*!< 2 bits, system clock switch status */
+#define RCC_CFGR_HPRE_Pos       4U   /*!< 4 bits, AHB prescaler */
+#define RCC_CFGR_PPRE1_Pos      10U  /*!< 3 bits, APB1 prescaler */
+#define RCC_CFGR_PPRE2_Pos      13U  /*!< 3 bits, APB2 prescaler */
+/** @} */ // end of RCC_CFGR_BIT_POS
+
+#define RCC_APB1ENR_PWR_EN_Pos  28U  /*!< PWR interface clock enable */
+
+/**
+ * @defgroup FLASH_ACR_BIT_POS FLASH ACR Bit Positions
+ * @{
+ */
+#define FLASH_ACR_LATENCY_Pos   0U   /*!< 3 bits, wait states */
+#define FLASH_ACR_PRFTEN_Pos    8U   /*!< Prefetch enable */
+#define FLASH_ACR_ICEN_Pos      9U   /*!< Instruction cache enable */
+#define FLASH_ACR_DCEN_Pos      10U  /*!< Data cache enable */
+#define FLASH_ACR_ICRST_Pos     11U  /*!< Instruction cache reset */
+#define FLASH_ACR_DCRST_Pos     12U  /*!< Data cache reset */
+/** @} */ // end of FLASH_ACR_BIT_POS
+
+#define PWR_CR_VOS_Pos          14U  /*!< Regulator voltage scale, 1: scale 1 (168 MHz) */
+
 
 
 
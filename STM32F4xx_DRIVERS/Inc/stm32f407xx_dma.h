@@ -0,0 +1,242 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_dma.h
+ * @author  Yuvraj Singh
+ * @brief   DMA Driver Header for STM32F407xx MCU
+ *
+ * This file contains:
+ *   - DMA stream configuration structure and handle
+ *   - Macros for channel, direction, data size and priority selection
+ *   - Stream interrupt flag and SxCR bit position macros
+ *   - Prototypes of the stream level DMA APIs used by peripheral drivers
+ *
+ * @version 1.0
+ * @date    02-Dec-2025
+ ******************************************************************************
+ */
+
+#ifndef INC_STM32F407XX_DMA_H_
+#define INC_STM32F407XX_DMA_H_
+
+#include "stm32f407xx.h"
+
+/**
+ * @defgroup DMA_Driver DMA Driver
+ * @brief    STM32F407xx DMA1/DMA2 stream driver
+ * @{
+ */
+
+/**
+ * @defgroup DMA_CONFIG_MACROS DMA Configuration Macros
+ * @brief DMA stream configuration Macros
+ * @{
+ */
+
+	/**
+	 * @defgroup DMA_CHANNEL_MACROS DMA Channel Macros
+	 * @ingroup DMA_CONFIG_MACROS
+	 * @brief Request channel selected with CHSEL[2:0] (see RM0090 DMA request mapping)
+	 * @{
+	 */
+		#define DMA_CHANNEL_0    0
+		#define DMA_CHANNEL_1    1
+		#define DMA_CHANNEL_2    2
+		#define DMA_CHANNEL_3    3
+		#define DMA_CHANNEL_4    4
+		#define DMA_CHANNEL_5    5
+		#define DMA_CHANNEL_6    6
+		#define DMA_CHANNEL_7    7
+	/** @} */   // end of DMA_CHANNEL_MACROS
+
+	/**
+	 * @defgroup DMA_DIRECTION_MACROS DMA Direction Macros
+	 * @ingroup DMA_CONFIG_MACROS
+	 * @{
+	 */
+		#define DMA_DIR_PERIPH_TO_MEM   0 /*!< Peripheral (PAR) to memory (M0AR) */
+		#define DMA_DIR_MEM_TO_PERIPH   1 /*!< Memory (M0AR) to peripheral (PAR) */
+		#define DMA_DIR_MEM_TO_MEM      2 /*!< Memory to memory, DMA2 only       */
+	/** @} */   // end of DMA_DIRECTION_MACROS
+
+	/**
+	 * @defgroup DMA_DATA_SIZE_MACROS DMA Data Size Macros
+	 * @ingroup DMA_CONFIG_MACROS
+	 * @{
+	 */
+		#define DMA_DATA_SIZE_BYTE       0 /*!< 8-bit  */
+		#define DMA_DATA_SIZE_HALF_WORD  1 /*!< 16-bit */
+		#define DMA_DATA_SIZE_WORD       2 /*!< 32-bit */
+	/** @} */   // end of DMA_DATA_SIZE_MACROS
+
+	/**
+	 * @defgroup DMA_PRIORITY_MACROS DMA Priority Macros
+	 * @ingroup DMA_CONFIG_MACROS
+	 * @{
+	 */
+		#define DMA_PRIORITY_LOW         0
+		#define DMA_PRIORITY_MEDIUM      1
+		#define DMA_PRIORITY_HIGH        2
+		#define DMA_PRIORITY_VERY_HIGH   3
+	/** @} */   // end of DMA_PRIORITY_MACROS
+
+	/**
+	 * @defgroup DMA_MEM_INC_MACROS DMA Memory Increment Macros
+	 * @ingroup DMA_CONFIG_MACROS
+	 * @{
+	 */
+		#define DMA_MEM_INC_DI    0 /*!< Memory address fixed (dummy source/sink) */
+		#define DMA_MEM_INC_EN    1 /*!< Memory address incremented per item     */
+	/** @} */   // end of DMA_MEM_INC_MACROS
+
+	/**
+	 * @defgroup DMA_CIRC_MACROS DMA Circular Mode Macros
+	 * @ingroup DMA_CONFIG_MACROS
+	 * @{
+	 */
+		#define DMA_CIRC_DI       0 /*!< Stream stops when NDTR reaches 0          */
+		#define DMA_CIRC_EN       1 /*!< NDTR and addresses reload automatically  */
+	/** @} */   // end of DMA_CIRC_MACROS
+
+/** @} */   // end of DMA_CONFIG_MACROS
+
+/**
+ * @defgroup DMA_FLAG_MACROS DMA Stream Flag Macros
+ * @brief Stream event flags as returned by DMAx_GetFlags().
+ *
+ * The controller packs the flags of 4 streams into LISR/HISR at bit offsets
+ * 0, 6, 16 and 22. The driver normalises them to the positions below so the
+ * same masks work for every stream, and for DMAx_Start() interrupt enables.
+ * @{
+ */
+	#define DMA_FLAG_FEIF     (1U << 0) /*!< FIFO error                   */
+	#define DMA_FLAG_DMEIF    (1U << 2) /*!< Direct mode error            */
+	#define DMA_FLAG_TEIF     (1U << 3) /*!< Transfer error               */
+	#define DMA_FLAG_HTIF     (1U << 4) /*!< Half transfer                */
+	#define DMA_FLAG_TCIF     (1U << 5) /*!< Transfer complete            */
+	#define DMA_FLAG_ALL      (DMA_FLAG_FEIF | DMA_FLAG_DMEIF | DMA_FLAG_TEIF | DMA_FLAG_HTIF | DMA_FLAG_TCIF)
+/** @} */   // end of DMA_FLAG_MACROS
+
+/**
+ * @defgroup DMA_Config_Struct DMA Configuration Structure definition
+ * @{
+ */
+typedef struct
+{
+    uint8_t DMA_CHANNEL;      /*!< Request channel.                 Refer @ref DMA_CHANNEL_MACROS   */
+    uint8_t DMA_DIRECTION;    /*!< Transfer direction.              Refer @ref DMA_DIRECTION_MACROS */
+    uint8_t DMA_DATA_SIZE;    /*!< Peripheral and memory item size. Refer @ref DMA_DATA_SIZE_MACROS */
+    uint8_t DMA_MEM_INC;      /*!< Memory address increment.        Refer @ref DMA_MEM_INC_MACROS   */
+    uint8_t DMA_CIRCULAR;     /*!< Circular mode.                   Refer @ref DMA_CIRC_MACROS      */
+    uint8_t DMA_PRIORITY;     /*!< Software priority.               Refer @ref DMA_PRIORITY_MACROS  */
+} DMAx_Config_t;
+/** @} */ // End of DMAx_Config_t Structure Definition
+
+/**
+ * @defgroup DMA_Handle_Struct DMA Handle Structure definition
+ * @{
+ */
+typedef struct
+{
+    DMA_RegDef_t  *pDMAx;      /*!< DMA1 or DMA2                */
+    uint8_t        STREAM;     /*!< Stream number 0..7          */
+    DMAx_Config_t  DMA_CONFIG; /*!< Stream configuration        */
+} DMAx_Handle_t;
+/** @} */ // End of DMAx_Handle_t Structure Definition
+
+/**
+ * @defgroup DMA_API_PROTOTYPES DMA API Prototypes
+ * @{
+ */
+
+/**
+ * @brief   Enable the controller clock and make sure the stream is stopped.
+ * @param   pDMA_Handle : Pointer to DMA handle structure.
+ * @return  None
+ */
+void DMAx_Init(DMAx_Handle_t *pDMA_Handle);
+
+/**
+ * @brief   Program and enable a stream.
+ *
+ * The stream is disabled first, its flags are cleared, then PAR, M0AR, NDTR
+ * and SxCR are written from the handle configuration before EN is set.
+ *
+ * @param   pDMA_Handle : Pointer to DMA handle structure.
+ * @param   PeriphAddr  : Peripheral register address (e.g. &SPIx->DR).
+ * @param   MemAddr     : Memory address, aligned to DMA_DATA_SIZE.
+ * @param   Count       : Number of items (not bytes), 1..65535.
+ * @param   ITMask      : Interrupts to enable, any of DMA_FLAG_TEIF,
+ *                        DMA_FLAG_HTIF, DMA_FLAG_TCIF, DMA_FLAG_DMEIF.
+ * @return  None
+ */
+void DMAx_Start(DMAx_Handle_t *pDMA_Handle, uint32_t PeriphAddr, uint32_t MemAddr,
+                uint16_t Count, uint32_t ITMask);
+
+/**
+ * @brief   Disable a stream and wait until the hardware has released it.
+ * @param   pDMA_Handle : Pointer to DMA handle structure.
+ * @return  None
+ */
+void DMAx_Stop(DMAx_Handle_t *pDMA_Handle);
+
+/**
+ * @brief   Read the event flags of a stream.
+ * @param   pDMAx  : DMA1 or DMA2.
+ * @param   Stream : Stream number 0..7.
+ * @return  uint8_t : @ref DMA_FLAG_MACROS
+ */
+uint8_t DMAx_GetFlags(DMA_RegDef_t *pDMAx, uint8_t Stream);
+
+/**
+ * @brief   Clear event flags of a stream.
+ * @param   pDMAx  : DMA1 or DMA2.
+ * @param   Stream : Stream number 0..7.
+ * @param   Flags  : @ref DMA_FLAG_MACROS to clear.
+ * @return  None
+ */
+void DMAx_ClearFlags(DMA_RegDef_t *pDMAx, uint8_t Stream, uint8_t Flags);
+
+/**
+ * @brief   Items still to be transferred (NDTR).
+ * @param   pDMA_Handle : Pointer to DMA handle structure.
+ * @return  uint16_t
+ */
+uint16_t DMAx_GetCounter(DMAx_Handle_t *pDMA_Handle);
+
+/**
+ * @brief   NVIC IRQ number of a stream.
+ * @param   pDMAx  : DMA1 or DMA2.
+ * @param   Stream : Stream number 0..7.
+ * @return  uint8_t : @ref IRQ_NUMBER_MACROS
+ */
+uint8_t DMAx_GetIRQNumber(DMA_RegDef_t *pDMAx, uint8_t Stream);
+
+/** @} */ // End of DMA_API_PROTOTYPES
+
+/**
+ * @defgroup DMA_SxCR_BIT_POSITIONS DMA Stream Configuration Register Bit Positions
+ * @{
+ */
+	#define DMA_SxCR_EN_Pos        0U
+	#define DMA_SxCR_DMEIE_Pos     1U
+	#define DMA_SxCR_TEIE_Pos      2U
+	#define DMA_SxCR_HTIE_Pos      3U
+	#define DMA_SxCR_TCIE_Pos      4U
+	#define DMA_SxCR_PFCTRL_Pos    5U
+	#define DMA_SxCR_DIR_Pos       6U   /*!< 2 bits */
+	#define DMA_SxCR_CIRC_Pos      8U
+	#define DMA_SxCR_PINC_Pos      9U
+	#define DMA_SxCR_MINC_Pos      10U
+	#define DMA_SxCR_PSIZE_Pos     11U  /*!< 2 bits */
+	#define DMA_SxCR_MSIZE_Pos     13U  /*!< 2 bits */
+	#define DMA_SxCR_PINCOS_Pos    15U
+	#define DMA_SxCR_PL_Pos        16U  /*!< 2 bits */
+	#define DMA_SxCR_DBM_Pos       18U
+	#define DMA_SxCR_CT_Pos        19U
+	#define DMA_SxCR_PBURST_Pos    21U  /*!< 2 bits */
+	#define DMA_SxCR_MBURST_Pos    23U  /*!< 2 bits */
+	#define DMA_SxCR_CHSEL_Pos     25U  /*!< 3 bits */
+/** @} */ // End of DMA_SxCR_BIT_POSITIONS
+
+/** @} */ // End of DMA_Driver
+#endif /* INC_STM32F407XX_DMA_H_ */
@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_flash.h
+ * @author  Yuvraj Singh
+ * @brief   Flash Interface Driver Header for STM32F407xx MCU
+ *
+ * This file contains:
+ *   - Wait state and ART accelerator macros
+ *   - Prototypes of the latency, prefetch and cache APIs
+ *
+ * The ART accelerator (prefetch buffer, 64 x 128-bit instruction cache,
+ * 8 x 128-bit data cache) hides the flash wait states. Without it every
+ * taken branch and every literal load from flash stalls for LATENCY cycles.
+ *
+ * @version 1.0
+ * @date    16-Dec-2025
+ ******************************************************************************
+ */
+
+#ifndef INC_STM32F407XX_FLASH_H_
+#define INC_STM32F407XX_FLASH_H_
+
+#include "stm32f407xx.h"
+
+/**
+ * @defgroup FLASH_Driver Flash Interface Driver
+ * @brief    STM32F407xx flash access control (latency and ART accelerator)
+ * @{
+ */
+
+/**
+ * @brief HCLK covered by one wait state, 30 MHz for a 2.7 V..3.6 V supply.
+ * @note  Use 24000000UL (2.4 V..2.7 V), 22000000UL (2.1 V..2.4 V) or
+ *        20000000UL (1.8 V..2.1 V) for lower supplies.
+ */
+#ifndef FLASH_WS_STEP_HZ
+#define FLASH_WS_STEP_HZ   30000000UL
+#endif
+
+/** Highest wait state setting, 7 */
+#define FLASH_LATENCY_MAX  7U
+
+/**
+ * @defgroup FLASH_ART_MACROS Flash ART Accelerator Macros
+ * @brief Features for flash_art_config(), can be ORed.
+ * @{
+ */
+	#define FLASH_ART_PREFETCH   (1U << FLASH_ACR_PRFTEN_Pos) /*!< Sequential prefetch buffer */
+	#define FLASH_ART_ICACHE     (1U << FLASH_ACR_ICEN_Pos)   /*!< Instruction cache          */
+	#define FLASH_ART_DCACHE     (1U << FLASH_ACR_DCEN_Pos)   /*!< Data (literal pool) cache  */
+	#define FLASH_ART_ALL        (FLASH_ART_PREFETCH | FLASH_ART_ICACHE | FLASH_ART_DCACHE)
+/** @} */ // end of FLASH_ART_MACROS
+
+/**
+ * @defgroup FLASH_API_PROTOTYPES Flash API Prototypes
+ * @{
+ */
+
+/**
+ * @brief   Wait states needed for an HCLK frequency.
+ * @param   Hclk : AHB clock in Hz.
+ * @return  uint8_t : 0..7
+ */
+uint8_t flash_latency_for_hclk(uint32_t Hclk);
+
+/**
+ * @brief   Program the wait states and wait until the interface uses them.
+ * @param   Latency : 0..7, see flash_latency_for_hclk().
+ * @note    Raise before increasing HCLK, lower after decreasing it.
+ * @return  None
+ */
+void flash_set_latency(uint8_t Latency);
+
+/**
+ * @brief   Current wait states.
+ * @return  uint8_t : 0..7
+ */
+uint8_t flash_get_latency(void);
+
+/**
+ * @brief   Select the ART accelerator features.
+ *
+ * Caches that are being enabled are flushed first (disabled, reset, enabled),
+ * so no line fetched before a latency change or a flash write is ever hit.
+ *
+ * @param   Features : @ref FLASH_ART_MACROS to enable, the others are disabled.
+ * @return  None
+ */
+void flash_art_config(uint32_t Features);
+
+/**
+ * @brief   Currently enabled ART accelerator features.
+ * @return  uint32_t : @ref FLASH_ART_MACROS
+ */
+uint32_t flash_art_get(void);
+
+/**
+ * @brief   Invalidate the instruction and data caches, keep the enabled features.
+ * @note    Needed after programming flash that may already be cached.
+ * @return  None
+ */
+void flash_cache_reset(void);
+
+/** @} */ // End of FLASH_API_PROTOTYPES
+
+/** @} */ // End of FLASH_Driver
+#endif /* INC_STM32F407XX_FLASH_H_ */
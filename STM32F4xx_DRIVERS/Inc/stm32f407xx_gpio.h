@@ -8,6 +8,9 @@
  *   - GPIO register definition structure
  *   - GPIO configuration structure
  *   - GPIO handle structure
+ *   - Compile-time pin table macros and per-port register images
+ *   - EXTI line callback registry and shared-vector dispatch
+ *   - EXTI edge capture with DWT cycle-counter timestamps
  *   - Supported macro definitions for GPIO modes, speed, pull-up/pull-down,
  *     output types, and alternate functions.
  *   - Doxygen-compliant documentation for easy code navigation and API usage.
@@ -21,6 +24,7 @@
 #define INC_STM32F407XX_GPIO_H_
 
 #include "stm32f407xx.h"
+#include "stm32f407xx_nvic.h"
 
 /**
  * @defgroup GPIO_Driver GPIO Driver
@@ -164,6 +168,172 @@ typedef struct {
 
 /** @} */ /* End of GPIO_Handle_Structure */
 
+/**
+ * @defgroup GPIO_Pin_Table GPIO Compile-Time Pin Table
+ * @brief    Static board pin tables, checked and reduced to register images by the compiler.
+ *
+ * A board describes its pins once as an X-macro list. Every entry passes the
+ * selector P through unchanged:
+ * @code
+ * #define BOARD_PINS(X, P) \
+ *     X(P, GPIO_PORT_A, GPIO_PIN_4, GPIO_MODE_ALT_FUNC, GPIO_OP_TYPE_PP, GPIO_SPEED_HIGH, GPIO_PU_PD_PULL_UP, GPIO_ALT_FUNC_6) \
+ *     X(P, GPIO_PORT_B, GPIO_PIN_3, GPIO_MODE_ALT_FUNC, GPIO_OP_TYPE_PP, GPIO_SPEED_HIGH, GPIO_PU_PD_NONE,    GPIO_ALT_FUNC_6)
+ *
+ * GPIO_PIN_TABLE_ASSERT(BOARD_PINS)
+ *
+ * static const GPIOx_PortImage_t board_gpio[] = {
+ *     GPIO_PORT_IMAGE(BOARD_PINS, GPIO_PORT_A),
+ *     GPIO_PORT_IMAGE(BOARD_PINS, GPIO_PORT_B),
+ * };
+ * ...
+ * gpio_port_apply_images(board_gpio, sizeof(board_gpio) / sizeof(board_gpio[0]));
+ * @endcode
+ *
+ * GPIO_PIN_TABLE_ASSERT() rejects, at compile time, a bad port, pin, mode,
+ * output type, speed, pull or AF value and any pin listed twice. GPIO_PORT_IMAGE()
+ * folds all entries of one port into constants, so the image lives in flash
+ * and no per-pin code is generated.
+ * @{
+ */
+
+/**
+ * @brief Register image of the pins of one port taken from a pin table.
+ * @note  Only the pins in PinMask are written, the others keep their setting.
+ */
+typedef struct {
+    GPIOx_RegDef_t *pGPIOx;   /*!< Port the image belongs to              */
+    uint16_t PinMask;         /*!< Pins owned by the table                */
+    uint16_t OTYPER;          /*!< Output type bits of those pins         */
+    uint32_t MODER;           /*!< Mode fields of those pins              */
+    uint32_t OSPEEDR;         /*!< Speed fields of those pins             */
+    uint32_t PUPDR;           /*!< Pull-up/pull-down fields of those pins */
+    uint32_t AFRL;            /*!< AF fields of pins 0..7                 */
+    uint32_t AFRH;            /*!< AF fields of pins 8..15                */
+} GPIOx_PortImage_t;
+
+/* Per-entry terms: contribute only when the entry's port is the selected one */
+#define GPIO_PT_ON(P, PORT)                       ((P) == (PORT))
+#define GPIO_PT_BIT(P, PORT, PIN)                 (GPIO_PT_ON(P, PORT) ? (1UL << ((PIN) & 0xFU)) : 0UL)
+#define GPIO_PT_F2(P, PORT, PIN, V)               (GPIO_PT_ON(P, PORT) ? ((uint32_t)(V) << (2U * ((PIN) & 0xFU))) : 0UL)
+#define GPIO_PT_F4(P, PORT, PIN, V, HI)           ((GPIO_PT_ON(P, PORT) && (((PIN) >> 3) & 1U) == (HI)) \
+                                                  ? ((uint32_t)(V) << (4U * ((PIN) & 0x7U))) : 0UL)
+
+#define GPIO_PT_MASK(P, PORT, PIN, MODE, OTYPE, SPEED, PUPD, AF)     | GPIO_PT_BIT(P, PORT, PIN)
+#define GPIO_PT_COUNT(P, PORT, PIN, MODE, OTYPE, SPEED, PUPD, AF)    + GPIO_PT_BIT(P, PORT, PIN)
+#define GPIO_PT_OTYPER(P, PORT, PIN, MODE, OTYPE, SPEED, PUPD, AF)   | ((OTYPE) ? GPIO_PT_BIT(P, PORT, PIN) : 0UL)
+#define GPIO_PT_MODER(P, PORT, PIN, MODE, OTYPE, SPEED, PUPD, AF)    | GPIO_PT_F2(P, PORT, PIN, MODE)
+#define GPIO_PT_OSPEEDR(P, PORT, PIN, MODE, OTYPE, SPEED, PUPD, AF)  | GPIO_PT_F2(P, PORT, PIN, SPEED)
+#define GPIO_PT_PUPDR(P, PORT, PIN, MODE, OTYPE, SPEED, PUPD, AF)    | GPIO_PT_F2(P, PORT, PIN, PUPD)
+#define GPIO_PT_AFRL(P, PORT, PIN, MODE, OTYPE, SPEED, PUPD, AF)     | GPIO_PT_F4(P, PORT, PIN, AF, 0U)
+#define GPIO_PT_AFRH(P, PORT, PIN, MODE, OTYPE, SPEED, PUPD, AF)     | GPIO_PT_F4(P, PORT, PIN, AF, 1U)
+
+#define GPIO_PT_CHECK(P, PORT, PIN, MODE, OTYPE, SPEED, PUPD, AF) \
+    _Static_assert((PORT) < GPIO_PORT_COUNT, "GPIO pin table: bad port "  #PORT "/" #PIN); \
+    _Static_assert((PIN) <= 15,              "GPIO pin table: bad pin "   #PORT "/" #PIN); \
+    _Static_assert((MODE) <= 3,              "GPIO pin table: bad mode "  #PORT "/" #PIN); \
+    _Static_assert((OTYPE) <= 1,             "GPIO pin table: bad output type " #PORT "/" #PIN); \
+    _Static_assert((SPEED) <= 3,             "GPIO pin table: bad speed " #PORT "/" #PIN); \
+    _Static_assert((PUPD) <= 2,              "GPIO pin table: bad pull "  #PORT "/" #PIN); \
+    _Static_assert((AF) <= 15,               "GPIO pin table: bad AF "    #PORT "/" #PIN);
+
+/* A pin listed twice adds its bit twice, so the sum differs from the OR */
+#define GPIO_PT_UNIQUE(TABLE, PORT) \
+    _Static_assert((0UL TABLE(GPIO_PT_COUNT, PORT)) == (0UL TABLE(GPIO_PT_MASK, PORT)), \
+                   "GPIO pin table: pin listed twice on port " #PORT);
+
+/**
+ * @brief Validate every entry of a pin table. Use at file scope.
+ */
+#define GPIO_PIN_TABLE_ASSERT(TABLE) \
+    TABLE(GPIO_PT_CHECK, 0U) \
+    GPIO_PT_UNIQUE(TABLE, GPIO_PORT_A) GPIO_PT_UNIQUE(TABLE, GPIO_PORT_B) \
+    GPIO_PT_UNIQUE(TABLE, GPIO_PORT_C) GPIO_PT_UNIQUE(TABLE, GPIO_PORT_D) \
+    GPIO_PT_UNIQUE(TABLE, GPIO_PORT_E) GPIO_PT_UNIQUE(TABLE, GPIO_PORT_F) \
+    GPIO_PT_UNIQUE(TABLE, GPIO_PORT_G) GPIO_PT_UNIQUE(TABLE, GPIO_PORT_H) \
+    GPIO_PT_UNIQUE(TABLE, GPIO_PORT_I)
+
+/**
+ * @brief Constant initializer of the @ref GPIOx_PortImage_t of one port.
+ * @param TABLE Pin table X-macro.
+ * @param PORT  GPIO_PORT_A .. GPIO_PORT_I.
+ */
+#define GPIO_PORT_IMAGE(TABLE, PORT) {                           \
+        .pGPIOx  = GPIO_PORT_FROM_INDEX(PORT),                   \
+        .PinMask = (uint16_t)(0UL TABLE(GPIO_PT_MASK, PORT)),    \
+        .OTYPER  = (uint16_t)(0UL TABLE(GPIO_PT_OTYPER, PORT)),  \
+        .MODER   = (0UL TABLE(GPIO_PT_MODER, PORT)),             \
+        .OSPEEDR = (0UL TABLE(GPIO_PT_OSPEEDR, PORT)),           \
+        .PUPDR   = (0UL TABLE(GPIO_PT_PUPDR, PORT)),             \
+        .AFRL    = (0UL TABLE(GPIO_PT_AFRL, PORT)),              \
+        .AFRH    = (0UL TABLE(GPIO_PT_AFRH, PORT)),              \
+    }
+
+/** @} */ /* End of GPIO_Pin_Table */
+
+
+/**
+ * @brief LCKR lock key bit: reads 1 once the port configuration is frozen.
+ */
+#define GPIO_LCKR_LCKK_Pos   16U
+
+/**
+ * @defgroup GPIO_EXTI_Dispatch GPIO EXTI Dispatch
+ * @brief    Per-line callbacks for EXTI0..15, demultiplexed from the shared vectors.
+ * @{
+ */
+
+/**
+ * @brief Set to 1 to let the driver define EXTI0..4_IRQHandler,
+ *        EXTI9_5_IRQHandler and EXTI15_10_IRQHandler.
+ * @note  Keep 0 when the application defines any of these handlers itself;
+ *        it can still call gpio_exti_dispatch() from them.
+ */
+#ifndef GPIO_EXTI_DISPATCH_EN
+#define GPIO_EXTI_DISPATCH_EN   0
+#endif
+
+#define GPIO_EXTI_LINES_9_5     0x03E0U   /*!< Lines served by IRQ_NUM_EXTI9_5   */
+#define GPIO_EXTI_LINES_15_10   0xFC00U   /*!< Lines served by IRQ_NUM_EXTI15_10 */
+#define GPIO_EXTI_LINES_ALL     0xFFFFU   /*!< EXTI0..15, the GPIO lines          */
+
+/**
+ * @brief EXTI line callback.
+ * @param line     EXTI line (= pin number) that fired.
+ * @param pContext Pointer given to gpio_exti_register().
+ * @note  Runs in interrupt context, the pending flag is already cleared.
+ */
+typedef void (*GPIO_ExtiCallback_t)(uint8_t line, void *pContext);
+
+/**
+ * @brief Records in the edge capture ring, power of two.
+ * @note  Can be overridden from the compiler command line.
+ */
+#ifndef GPIO_EXTI_CAPTURE_LEN
+#define GPIO_EXTI_CAPTURE_LEN   32
+#endif
+
+/**
+ * @brief One captured edge.
+ */
+typedef struct {
+    uint32_t Timestamp;   /*!< DWT CYCCNT at entry of the dispatching vector */
+    uint8_t  Line;        /*!< EXTI line (= pin number)                      */
+    uint8_t  Level;       /*!< Pin level read while serving the edge         */
+} GPIO_ExtiCapture_t;
+
+/**
+ * @defgroup GPIO_WAKE_SOURCES GPIO Wait Wake-Up Sources
+ * @brief Return values of gpio_wait_for_edge().
+ * @{
+ */
+
+#define GPIO_WAKE_LEVEL      0   /*!< Pin read the requested level (real edge) */
+#define GPIO_WAKE_SOFTWARE   1   /*!< gpio_exti_software_trigger() of the line */
+#define GPIO_WAKE_INVALID    2   /*!< Pin above 15, nothing waited for          */
+
+/** @} */ /* end of GPIO_WAKE_SOURCES */
+
+/** @} */ /* End of GPIO_EXTI_Dispatch */
 
 /*================================================================================
  *===============================GPIO_Driver_APIs=================================
@@ -182,6 +352,64 @@ typedef struct {
  */
 void gpio_pin_init(GPIOx_Handle_t *handle);
 
+/**
+ * @brief Configure several pins of one port with the same settings.
+ *
+ * Builds the 2-bit (MODER/OSPEEDR/PUPDR) and 4-bit (AFRL/AFRH) field masks of
+ * all selected pins and updates each register with a single store, instead
+ * of one clear and one set per pin as gpio_pin_init() does.
+ *
+ * @param pGPIOx   Pointer to the GPIO port base address. @ref GPIO_BASE_ADDRESSES
+ * @param pin_mask Bit n selects pin n.
+ * @param pConfig  Settings applied to every selected pin, GPIO_PIN_NUMBER is ignored.
+ * @retval void
+ * @note  Enables the port clock. MODER is written last, so a pin switched to
+ *        output or AF already has its final type, speed, pull and AF.
+ */
+void gpio_port_init_mask(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask, const GPIOx_Config_t *pConfig);
+
+/**
+ * @brief Apply a compile-time port image.
+ *
+ * Enables the port clock and writes OSPEEDR, OTYPER, PUPDR, AFRL, AFRH and
+ * finally MODER, each with a single store limited to the pins of the image.
+ *
+ * @param pImage Image built with GPIO_PORT_IMAGE(). @ref GPIO_Pin_Table
+ * @retval void
+ */
+void gpio_port_apply_image(const GPIOx_PortImage_t *pImage);
+
+/**
+ * @brief Apply an array of port images, e.g. the whole board at startup.
+ * @param pImages Array of images.
+ * @param count   Number of images.
+ * @retval void
+ */
+void gpio_port_apply_images(const GPIOx_PortImage_t *pImages, uint32_t count);
+
+/**
+ * @brief Freeze the configuration of the selected pins until the next reset.
+ *
+ * Runs the LCKR key sequence (write LCKK=1, LCKK=0, LCKK=1 with the same pin
+ * mask, then read LCKR twice) and checks that LCKK reads back as 1. After that
+ * MODER, OTYPER, OSPEEDR, PUPDR and AFRL/AFRH of the pins ignore writes.
+ *
+ * @param pGPIOx   Pointer to the GPIO port base address. @ref GPIO_BASE_ADDRESSES
+ * @param pin_mask Pins to lock. Pins already locked stay locked.
+ * @retval uint8_t SET if the port is locked, RESET if the sequence failed
+ *                 (e.g. the port was already locked with another mask).
+ * @note  Only a system reset or a port reset (gpio_port_deinit()) unlocks.
+ */
+uint8_t gpio_port_lock(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask);
+
+/**
+ * @brief Pins of a port whose configuration is locked.
+ * @param pGPIOx Pointer to the GPIO port base address. @ref GPIO_BASE_ADDRESSES
+ * @retval uint16_t Locked pins, 0 if the port was never locked.
+ * @note  Callers can skip re-applying the configuration of these pins.
+ */
+uint16_t gpio_port_get_locked(GPIOx_RegDef_t *pGPIOx);
+
 /**
  * @brief De-initialize a GPIO port.
  * @param pGPIOx Pointer to the GPIO port base address. @ref GPIO_BASE_ADDRESSES
@@ -206,7 +434,7 @@ uint8_t gpio_read_pin(GPIOx_RegDef_t *pGPIOx, uint8_t pin);
 uint16_t gpio_read_port(GPIOx_RegDef_t *pGPIOx);
 
 /**
- * @brief Write HIGH/LOW to a pin.
+ * @brief Write HIGH/LOW to a pin with a single BSRR store.
  * @param pGPIOx Pointer to the GPIO port base address. @ref GPIO_BASE_ADDRESSES
  * @param Pin number to which you want to write.
  * @param State you want to set, Set/Reset @ref MISCELLANEOUS_MACROS
@@ -229,6 +457,41 @@ void gpio_write_port(GPIOx_RegDef_t *pGPIOx, uint16_t write_data);
  */
 void gpio_toggle_pin(GPIOx_RegDef_t *pGPIOx, uint8_t pin);
 
+/**
+ * @brief Drive the selected pins HIGH.
+ * @param pGPIOx Pointer to the GPIO port base address. @ref GPIO_BASE_ADDRESSES
+ * @param pin_mask Bit n selects pin n.
+ * @note  Single BSRR store: atomic, other pins of the port are not touched.
+ */
+void gpio_set_pins(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask);
+
+/**
+ * @brief Drive the selected pins LOW.
+ * @param pGPIOx Pointer to the GPIO port base address. @ref GPIO_BASE_ADDRESSES
+ * @param pin_mask Bit n selects pin n.
+ * @note  Single BSRR store: atomic, other pins of the port are not touched.
+ */
+void gpio_clear_pins(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask);
+
+/**
+ * @brief Write several pins at once: pins in @p pin_mask take the matching
+ *        bit of @p value, the other pins keep their level.
+ * @param pGPIOx Pointer to the GPIO port base address. @ref GPIO_BASE_ADDRESSES
+ * @param pin_mask Pins to update.
+ * @param value    New levels, bits outside @p pin_mask are ignored.
+ * @note  Single BSRR store: all selected pins change on the same cycle.
+ */
+void gpio_write_pins_masked(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask, uint16_t value);
+
+/**
+ * @brief Toggle the selected pins.
+ * @param pGPIOx Pointer to the GPIO port base address. @ref GPIO_BASE_ADDRESSES
+ * @param pin_mask Pins to toggle.
+ * @note  Reads ODR once and writes BSRR once, so pins outside @p pin_mask
+ *        written by an ISR in between are not reverted.
+ */
+void gpio_toggle_pins(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask);
+
 /**
  * @brief Configure a GPIO pin as an external interrupt (EXTI).
  *
@@ -264,12 +527,117 @@ void gpio_irq_control(uint8_t pin, uint8_t en_di);
  *
  * @param pin  GPIO pin number (0–15) associated with the EXTI line.
  *
- * @note  This function writes a '1' to the EXTI_PR register bit.
+ * @note  This function writes a '1' to the EXTI_PR register bit only;
+ *        PR is write-1-to-clear, so other pending lines are left alone.
  *        Clearing the EXTI pending bit also clears the corresponding
  *        NVIC pending state automatically — no NVIC action is needed.
  */
 void gpio_irq_clear(uint8_t pin);
 
+/**
+ * @brief Configure a GPIO pin as an EXTI event source (event mode).
+ *
+ * Maps the port to the EXTI line, selects the trigger edges and sets the EMR
+ * bit. The edge wakes the core from WFE without any interrupt: IMR, PR and
+ * the NVIC are not touched.
+ *
+ * @param pGPIOx  Pointer to the GPIO port (GPIOA, GPIOB, ...) @ref GPIO_BASE_ADDRESSES
+ * @param pin     GPIO pin number (0–15) @ref GPIO_PIN_NUMBER_MACROS
+ * @param trigger Edge selection @ref INTERRUPT_TRIGGER_TYPE_MACROS
+ */
+void gpio_event_config(GPIOx_RegDef_t *pGPIOx, uint8_t pin, uint8_t trigger);
+
+/**
+ * @brief Enable or disable the event output of an EXTI line (EMR bit).
+ * @param pin    EXTI line 0..15.
+ * @param en_di  ENABLE or DISABLE.
+ */
+void gpio_event_control(uint8_t pin, uint8_t en_di);
+
+/**
+ * @brief Sleep with WFE until a pin reads @p level.
+ *
+ * Replaces polling loops such as while(gpio_read_pin(...)). The core sleeps
+ * between events and re-checks the pin after each wake-up.
+ *
+ * @param pGPIOx Pointer to the GPIO port base address. @ref GPIO_BASE_ADDRESSES
+ * @param pin    Pin configured with gpio_event_config(), trigger towards @p level.
+ * @param level  SET or RESET.
+ * @note  Returns at once if the pin is already at @p level, and also after a
+ *        gpio_exti_software_trigger() of the line (used for testing).
+ * @return @ref GPIO_WAKE_SOURCES: GPIO_WAKE_LEVEL once the pin reads @p level,
+ *         GPIO_WAKE_SOFTWARE for a software trigger, GPIO_WAKE_INVALID for
+ *         a pin above 15.
+ */
+uint8_t gpio_wait_for_edge(GPIOx_RegDef_t *pGPIOx, uint8_t pin, uint8_t level);
+
+/**
+ * @brief Raise an EXTI line from software through SWIER.
+ *
+ * An interrupt-mode line sets PR and enters its handler as for a real edge.
+ * An event-mode line generates an event, waking gpio_wait_for_edge().
+ *
+ * @param line EXTI line 0..15.
+ */
+void gpio_exti_software_trigger(uint8_t line);
+
+/**
+ * @brief Register the callback of an EXTI line.
+ * @param line     EXTI line 0..15.
+ * @param callback Function run by gpio_exti_dispatch(), NULL removes it.
+ * @param pContext Passed back to the callback.
+ * @note  Call before the line is enabled with gpio_irq_config()/gpio_irq_control(),
+ *        or with the line masked.
+ */
+void gpio_exti_register(uint8_t line, GPIO_ExtiCallback_t callback, void *pContext);
+
+/**
+ * @brief Serve the pending, unmasked EXTI lines in @p line_mask.
+ *
+ * Reads PR once, clears all lines it is about to serve with a single write
+ * and visits only the set bits, highest line first, with count-leading-zeros.
+ * Lines without a callback are just cleared.
+ *
+ * @param line_mask Lines owned by the calling vector, e.g. @ref GPIO_EXTI_LINES_9_5.
+ * @retval void
+ */
+void gpio_exti_dispatch(uint32_t line_mask);
+
+/**
+ * @brief Start stamping edges of the selected lines.
+ *
+ * Enables the DWT cycle counter. From then on gpio_exti_dispatch() stores a
+ * (line, level, CYCCNT) record for every served line in @p line_mask, before
+ * its callback runs. Pulse widths are differences of timestamps, in HCLK cycles.
+ *
+ * @param line_mask Lines to capture, added to the lines already captured.
+ * @note  The ring has a single producer: the vectors of all captured lines
+ *        must have the same NVIC priority so they never preempt each other.
+ *        Two edges of one line before its vector runs give a single record.
+ */
+void gpio_exti_capture_start(uint32_t line_mask);
+
+/**
+ * @brief Stop stamping edges of the selected lines.
+ * @param line_mask Lines to remove from capture.
+ */
+void gpio_exti_capture_stop(uint32_t line_mask);
+
+/**
+ * @brief Move captured records out of the ring, oldest first.
+ * @param pOut  Destination array.
+ * @param max   Capacity of @p pOut in records.
+ * @retval uint32_t Number of records copied.
+ * @note  Thread mode only (single consumer), no interrupt masking needed.
+ */
+uint32_t gpio_exti_capture_drain(GPIO_ExtiCapture_t *pOut, uint32_t max);
+
+/**
+ * @brief Records dropped because the ring was full.
+ * @retval uint32_t
+ */
+uint32_t gpio_exti_capture_get_overflow_count(void);
+
 /** @} */ /* end of GPIO_Driver_APIs */
 
 /** @} */ /* End of GPIO_Driver */
@@ -0,0 +1,132 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_gpio_debounce.h
+ * @author  Yuvraj Singh
+ * @brief   Non-blocking button/edge debouncing for STM32F407xx MCU
+ *
+ * This file contains:
+ *   - Debounced input descriptor
+ *   - Debounce event codes and event queue entry
+ *   - Prototypes of the debounce service APIs
+ *
+ * The EXTI interrupt of a button only masks its line and marks the button
+ * active, nothing waits inside the ISR. A periodic tick (SysTick, a timer or
+ * the main loop) samples the pin until it has been stable long enough, queues
+ * press/release/long-press events and unmasks the line again once the button
+ * is released and settled.
+ *
+ * @version 1.0
+ * @date    10-Dec-2025
+ ******************************************************************************
+ */
+
+#ifndef INC_STM32F407XX_GPIO_DEBOUNCE_H_
+#define INC_STM32F407XX_GPIO_DEBOUNCE_H_
+
+#include "stm32f407xx_gpio.h"
+
+/**
+ * @defgroup GPIO_DEBOUNCE GPIO Debounce Service
+ * @brief    Press/release/long-press events from bouncing inputs
+ * @{
+ */
+
+/**
+ * @brief Ticks the level must stay unchanged before it is accepted.
+ * @note  Can be overridden from the compiler command line.
+ */
+#ifndef GPIO_DEBOUNCE_SETTLE_TICKS
+#define GPIO_DEBOUNCE_SETTLE_TICKS   20
+#endif
+
+/**
+ * @brief Ticks a press must last to report GPIO_DEBOUNCE_EVENT_LONG_PRESS.
+ */
+#ifndef GPIO_DEBOUNCE_LONG_TICKS
+#define GPIO_DEBOUNCE_LONG_TICKS     1000
+#endif
+
+/**
+ * @brief Depth of the event queue, power of two.
+ */
+#ifndef GPIO_DEBOUNCE_QUEUE_LEN
+#define GPIO_DEBOUNCE_QUEUE_LEN      16
+#endif
+
+/**
+ * @defgroup GPIO_DEBOUNCE_EVENT_MACROS Debounce Event Macros
+ * @{
+ */
+	#define GPIO_DEBOUNCE_EVENT_PRESS        0 /*!< Input settled at the active level   */
+	#define GPIO_DEBOUNCE_EVENT_RELEASE      1 /*!< Input settled back at rest          */
+	#define GPIO_DEBOUNCE_EVENT_LONG_PRESS   2 /*!< Still pressed after the long delay  */
+/** @} */ // end of GPIO_DEBOUNCE_EVENT_MACROS
+
+/**
+ * @brief Debounced input. The first four members are set by the application.
+ */
+typedef struct
+{
+    GPIOx_RegDef_t *pGPIOx;        /*!< Port, pin already configured as input      */
+    uint8_t  Pin;                  /*!< Pin 0..15, also its EXTI line              */
+    uint8_t  ActiveLevel;          /*!< Level while pressed, SET or RESET          */
+    uint8_t  IrqPriority;          /*!< NVIC priority of the EXTI line             */
+    volatile uint8_t  Active;      /*!< Line masked, the tick is sampling the pin  */
+    uint8_t  Pressed;              /*!< Debounced state                            */
+    uint8_t  LongSent;             /*!< Long press already reported                */
+    uint16_t StableTicks;          /*!< Ticks the raw level disagreed with Pressed */
+    uint32_t HeldTicks;            /*!< Ticks since the debounced press            */
+} GPIO_DebounceButton_t;
+
+/**
+ * @brief Entry of the event queue.
+ */
+typedef struct
+{
+    uint8_t Pin;                   /*!< Pin of the button                          */
+    uint8_t Event;                 /*!< @ref GPIO_DEBOUNCE_EVENT_MACROS            */
+} GPIO_DebounceEvent_t;
+
+/**
+ * @defgroup GPIO_DEBOUNCE_API_PROTOTYPES Debounce API Prototypes
+ * @{
+ */
+
+/**
+ * @brief   Start debouncing a button.
+ *
+ * Registers the button on its EXTI line with gpio_exti_register(), configures
+ * the line for the edge towards the active level and enables it.
+ *
+ * @param   pButton : Button, application members filled in, kept alive by the caller.
+ * @note    The vector of the line must reach gpio_exti_dispatch(), either with
+ *          GPIO_EXTI_DISPATCH_EN=1 or from the application's handler.
+ * @return  None
+ */
+void gpio_debounce_init(GPIO_DebounceButton_t *pButton);
+
+/**
+ * @brief   Advance every active button by one tick.
+ * @note    Call periodically, e.g. from SysTick_Handler at 1 kHz. Only buttons
+ *          woken by an edge are sampled, idle buttons cost nothing.
+ * @return  None
+ */
+void gpio_debounce_tick(void);
+
+/**
+ * @brief   Take the oldest queued event.
+ * @param   pEvent : Filled when an event is returned.
+ * @return  uint8_t : 1 if an event was taken, 0 if the queue is empty.
+ */
+uint8_t gpio_debounce_get_event(GPIO_DebounceEvent_t *pEvent);
+
+/**
+ * @brief   Events dropped because the queue was full.
+ * @return  uint32_t
+ */
+uint32_t gpio_debounce_get_overflow_count(void);
+
+/** @} */ // End of GPIO_DEBOUNCE_API_PROTOTYPES
+
+/** @} */ // End of GPIO_DEBOUNCE
+#endif /* INC_STM32F407XX_GPIO_DEBOUNCE_H_ */
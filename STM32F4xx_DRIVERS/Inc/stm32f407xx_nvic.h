@@ -0,0 +1,229 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_nvic.h
+ * @author  Yuvraj Singh
+ * @brief   NVIC Driver Header for STM32F407xx MCU
+ *
+ * This file contains:
+ *   - Priority grouping macros (AIRCR PRIGROUP)
+ *   - Prototypes of the IRQ enable/disable/pending/active APIs
+ *   - Priority and sub-priority encoding
+ *   - BASEPRI and PRIMASK based critical sections
+ *
+ * Works for any IRQ number of @ref IRQ_NUMBER_MACROS. Drivers (GPIO EXTI,
+ * SPI, DMA) route their interrupt setup through this module.
+ *
+ * @version 1.0
+ * @date    12-Dec-2025
+ ******************************************************************************
+ */
+
+#ifndef INC_STM32F407XX_NVIC_H_
+#define INC_STM32F407XX_NVIC_H_
+
+#include "stm32f407xx.h"
+
+/**
+ * @defgroup NVIC_Driver NVIC Driver
+ * @brief    Cortex-M4 interrupt controller driver
+ * @{
+ */
+
+/**
+ * @brief Keep a copy of the vector table in SRAM so handlers can be installed
+ *        at runtime with nvic_set_vector(). Costs 512 bytes of SRAM.
+ * @note  Can be overridden from the compiler command line.
+ */
+#ifndef NVIC_VECTOR_TABLE_RAM_EN
+#define NVIC_VECTOR_TABLE_RAM_EN   0
+#endif
+
+/** Entries of the vector table: initial SP, 15 core exceptions, 82 IRQs */
+#define NVIC_VECTOR_COUNT          (16U + IRQ_NUM_FPU + 1U)
+
+/** VTOR alignment: table size rounded up to a power of two (98 words -> 512 bytes) */
+#define NVIC_VECTOR_TABLE_ALIGN    512U
+
+/**
+ * @brief Interrupt handler, as stored in the vector table.
+ */
+typedef void (*NVIC_Handler_t)(void);
+
+/**
+ * @defgroup NVIC_PRIORITY_GROUP_MACROS NVIC Priority Group Macros
+ * @brief Split of the 4 priority bits into preemption priority / sub-priority.
+ *
+ * Only the preemption priority decides whether an interrupt can interrupt
+ * another one; the sub-priority orders pending interrupts of equal
+ * preemption priority.
+ * @{
+ */
+	#define NVIC_PRIORITY_GROUP_4   3U  /*!< 4 bits preemption (0..15), 0 bits sub (reset default) */
+	#define NVIC_PRIORITY_GROUP_3   4U  /*!< 3 bits preemption (0..7),  1 bit  sub (0..1)          */
+	#define NVIC_PRIORITY_GROUP_2   5U  /*!< 2 bits preemption (0..3),  2 bits sub (0..3)          */
+	#define NVIC_PRIORITY_GROUP_1   6U  /*!< 1 bit  preemption (0..1),  3 bits sub (0..7)          */
+	#define NVIC_PRIORITY_GROUP_0   7U  /*!< 0 bits preemption,         4 bits sub (0..15)         */
+/** @} */ // end of NVIC_PRIORITY_GROUP_MACROS
+
+/**
+ * @defgroup NVIC_API_PROTOTYPES NVIC API Prototypes
+ * @{
+ */
+
+/**
+ * @brief   Enable an interrupt in the NVIC (single ISER store).
+ * @param   IRQNumber : @ref IRQ_NUMBER_MACROS
+ * @return  None
+ */
+void nvic_enable_irq(uint8_t IRQNumber);
+
+/**
+ * @brief   Disable an interrupt in the NVIC (single ICER store).
+ * @param   IRQNumber : @ref IRQ_NUMBER_MACROS
+ * @note    Ends with DSB/ISB, the interrupt cannot be taken after the return.
+ * @return  None
+ */
+void nvic_disable_irq(uint8_t IRQNumber);
+
+/**
+ * @brief   Check whether an interrupt is enabled.
+ * @param   IRQNumber : @ref IRQ_NUMBER_MACROS
+ * @return  uint8_t : 1 if enabled.
+ */
+uint8_t nvic_is_enabled(uint8_t IRQNumber);
+
+/**
+ * @brief   Set an interrupt pending, e.g. to run its handler from software.
+ * @param   IRQNumber : @ref IRQ_NUMBER_MACROS
+ * @return  None
+ */
+void nvic_set_pending(uint8_t IRQNumber);
+
+/**
+ * @brief   Clear the NVIC pending state of an interrupt.
+ * @param   IRQNumber : @ref IRQ_NUMBER_MACROS
+ * @note    A level still asserted by the peripheral sets it again.
+ * @return  None
+ */
+void nvic_clear_pending(uint8_t IRQNumber);
+
+/**
+ * @brief   Check whether an interrupt is pending.
+ * @param   IRQNumber : @ref IRQ_NUMBER_MACROS
+ * @return  uint8_t : 1 if pending.
+ */
+uint8_t nvic_is_pending(uint8_t IRQNumber);
+
+/**
+ * @brief   Check whether an interrupt handler is running (or preempted).
+ * @param   IRQNumber : @ref IRQ_NUMBER_MACROS
+ * @return  uint8_t : 1 if active.
+ */
+uint8_t nvic_is_active(uint8_t IRQNumber);
+
+/**
+ * @brief   Select the priority grouping (AIRCR PRIGROUP).
+ * @param   PriorityGroup : @ref NVIC_PRIORITY_GROUP_MACROS
+ * @note    Set once at startup, before any priority is encoded.
+ * @return  None
+ */
+void nvic_set_priority_grouping(uint8_t PriorityGroup);
+
+/**
+ * @brief   Current priority grouping.
+ * @return  uint8_t : @ref NVIC_PRIORITY_GROUP_MACROS
+ */
+uint8_t nvic_get_priority_grouping(void);
+
+/**
+ * @brief   Build a 4-bit priority from preemption priority and sub-priority
+ *          according to the current grouping.
+ * @param   PreemptPriority : 0 = highest, range depends on the grouping.
+ * @param   SubPriority     : 0 = highest, range depends on the grouping.
+ * @return  uint8_t : Priority for nvic_set_priority(), 0..15.
+ */
+uint8_t nvic_encode_priority(uint8_t PreemptPriority, uint8_t SubPriority);
+
+/**
+ * @brief   Set the priority of an interrupt (single byte store to its IPR byte).
+ * @param   IRQNumber : @ref IRQ_NUMBER_MACROS
+ * @param   Priority  : 0..15, @ref NVIC_IRQ_PRIORITY_LEVELS or nvic_encode_priority().
+ * @return  None
+ */
+void nvic_set_priority(uint8_t IRQNumber, uint8_t Priority);
+
+/**
+ * @brief   Priority of an interrupt.
+ * @param   IRQNumber : @ref IRQ_NUMBER_MACROS
+ * @return  uint8_t : 0..15
+ */
+uint8_t nvic_get_priority(uint8_t IRQNumber);
+
+/**
+ * @brief   Mask all interrupts with priority @p Priority or lower (numerically
+ *          greater or equal), keep the more urgent ones running.
+ *
+ * Uses BASEPRI_MAX, so nested sections can only raise the masking level.
+ *
+ * @param   Priority : 1..15. 0 cannot be masked by BASEPRI, use PRIMASK for that.
+ * @return  uint32_t : Previous BASEPRI, for nvic_critical_exit().
+ */
+uint32_t nvic_critical_enter(uint8_t Priority);
+
+/**
+ * @brief   Leave a section started with nvic_critical_enter().
+ * @param   PrevBasepri : Value returned by nvic_critical_enter().
+ * @return  None
+ */
+void nvic_critical_exit(uint32_t PrevBasepri);
+
+/**
+ * @brief   Mask all maskable interrupts (PRIMASK), whatever their priority.
+ *
+ * For data shared with handlers of any priority. Sections nest: each
+ * nvic_irq_restore() puts back the state its nvic_irq_save() found.
+ *
+ * @return  uint32_t : Previous PRIMASK, for nvic_irq_restore().
+ */
+uint32_t nvic_irq_save(void);
+
+/**
+ * @brief   Leave a section started with nvic_irq_save().
+ * @param   PrevPrimask : Value returned by nvic_irq_save().
+ * @return  None
+ */
+void nvic_irq_restore(uint32_t PrevPrimask);
+
+/**
+ * @brief   Handler currently installed for an interrupt (read through VTOR).
+ * @param   IRQNumber : @ref IRQ_NUMBER_MACROS
+ * @return  NVIC_Handler_t : NULL if IRQNumber is above IRQ_NUM_FPU.
+ */
+NVIC_Handler_t nvic_get_vector(uint8_t IRQNumber);
+
+#if NVIC_VECTOR_TABLE_RAM_EN
+/**
+ * @brief   Copy the active vector table to SRAM and point VTOR at the copy.
+ *
+ * Exception entry then fetches the vector from SRAM, in parallel with the
+ * stacking on the D-bus, instead of from flash. Call once at startup.
+ *
+ * @return  None
+ */
+void nvic_vector_table_relocate(void);
+
+/**
+ * @brief   Install an interrupt handler at runtime.
+ * @param   IRQNumber : @ref IRQ_NUMBER_MACROS
+ * @param   pfHandler : New handler; tag it RAMFUNC for a flash free interrupt path.
+ * @note    Disable the IRQ while swapping a handler that may be running.
+ * @return  uint8_t : SET if installed, RESET if the table was not relocated
+ *                    or IRQNumber is above IRQ_NUM_FPU.
+ */
+uint8_t nvic_set_vector(uint8_t IRQNumber, NVIC_Handler_t pfHandler);
+#endif
+
+/** @} */ // End of NVIC_API_PROTOTYPES
+
+/** @} */ // End of NVIC_Driver
+#endif /* INC_STM32F407XX_NVIC_H_ */
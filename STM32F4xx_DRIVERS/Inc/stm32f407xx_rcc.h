@@ -0,0 +1,276 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_rcc.h
+ * @author  Yuvraj Singh
+ * @brief   RCC Clock Tree Driver Header for STM32F407xx MCU
+ *
+ * This file contains:
+ *   - Clock source, PLL and bus prescaler configuration macros
+ *   - Clock configuration structure
+ *   - Prototypes of the clock setup and clock query APIs
+ *
+ * Drivers that derive timings from a bus clock (SPI baud rate, SysTick
+ * reload, ...) read it with rcc_get_hclk()/rcc_get_pclk1()/rcc_get_pclk2()
+ * instead of assuming the 16 MHz HSI reset clock.
+ *
+ * @version 1.0
+ * @date    15-Dec-2025
+ ******************************************************************************
+ */
+
+#ifndef INC_STM32F407XX_RCC_H_
+#define INC_STM32F407XX_RCC_H_
+
+#include "stm32f407xx.h"
+#include "stm32f407xx_flash.h"
+
+/**
+ * @defgroup RCC_Driver RCC Driver
+ * @brief    STM32F407xx clock tree driver
+ * @{
+ */
+
+/**
+ * @brief HSE crystal frequency in Hz, 8 MHz on the STM32F4DISCOVERY board.
+ * @note  Can be overridden from the compiler command line.
+ */
+#ifndef RCC_HSE_VALUE
+#define RCC_HSE_VALUE   8000000UL
+#endif
+
+/** @brief HSI RC oscillator frequency in Hz */
+#define RCC_HSI_VALUE   16000000UL
+
+/**
+ * @brief Polling iterations before HSE start-up or PLL lock is declared failed.
+ * @note  Can be overridden from the compiler command line.
+ */
+#ifndef RCC_READY_TIMEOUT
+#define RCC_READY_TIMEOUT   100000UL
+#endif
+
+/**
+ * @brief Clock change hooks that can be registered at the same time.
+ * @note  Can be overridden from the compiler command line.
+ */
+#ifndef RCC_CLOCK_HOOK_MAX
+#define RCC_CLOCK_HOOK_MAX   8
+#endif
+
+/**
+ * @defgroup RCC_LIMIT_MACROS RCC Frequency Limits (VOS scale 1, 2.7 V..3.6 V)
+ * @{
+ */
+	#define RCC_SYSCLK_MAX_HZ     168000000UL
+	#define RCC_PCLK1_MAX_HZ       42000000UL
+	#define RCC_PCLK2_MAX_HZ       84000000UL
+	#define RCC_VOS_SCALE2_MAX_HZ 144000000UL  /*!< Highest SYSCLK with the regulator in scale 2 */
+/** @} */ // end of RCC_LIMIT_MACROS
+
+/**
+ * @defgroup RCC_CONFIG_MACROS RCC Configuration Macros
+ * @{
+ */
+
+	/**
+	 * @defgroup RCC_SYSCLK_SOURCE_MACROS RCC System Clock Source Macros
+	 * @ingroup RCC_CONFIG_MACROS
+	 * @{
+	 */
+		#define RCC_SYSCLK_SOURCE_HSI   0 /*!< 16 MHz internal RC (reset default) */
+		#define RCC_SYSCLK_SOURCE_HSE   1 /*!< External crystal, RCC_HSE_VALUE     */
+		#define RCC_SYSCLK_SOURCE_PLL   2 /*!< Main PLL P output                    */
+	/** @} */ // end of RCC_SYSCLK_SOURCE_MACROS
+
+	/**
+	 * @defgroup RCC_PLL_SOURCE_MACROS RCC PLL Source Macros
+	 * @ingroup RCC_CONFIG_MACROS
+	 * @{
+	 */
+		#define RCC_PLL_SOURCE_HSI      0
+		#define RCC_PLL_SOURCE_HSE      1
+	/** @} */ // end of RCC_PLL_SOURCE_MACROS
+
+	/**
+	 * @defgroup RCC_AHB_PRESC_MACROS RCC AHB Prescaler Macros
+	 * @ingroup RCC_CONFIG_MACROS
+	 * @brief HPRE field values, HCLK = SYSCLK / n
+	 * @{
+	 */
+		#define RCC_AHB_DIV_1      0
+		#define RCC_AHB_DIV_2      8
+		#define RCC_AHB_DIV_4      9
+		#define RCC_AHB_DIV_8      10
+		#define RCC_AHB_DIV_16     11
+		#define RCC_AHB_DIV_64     12
+		#define RCC_AHB_DIV_128    13
+		#define RCC_AHB_DIV_256    14
+		#define RCC_AHB_DIV_512    15
+	/** @} */ // end of RCC_AHB_PRESC_MACROS
+
+	/**
+	 * @defgroup RCC_APB_PRESC_MACROS RCC APB Prescaler Macros
+	 * @ingroup RCC_CONFIG_MACROS
+	 * @brief PPRE1/PPRE2 field values, PCLKx = HCLK / n
+	 * @{
+	 */
+		#define RCC_APB_DIV_1      0
+		#define RCC_APB_DIV_2      4
+		#define RCC_APB_DIV_4      5
+		#define RCC_APB_DIV_8      6
+		#define RCC_APB_DIV_16     7
+	/** @} */ // end of RCC_APB_PRESC_MACROS
+
+/** @} */ // end of RCC_CONFIG_MACROS
+
+/**
+ * @defgroup RCC_STATUS_MACROS RCC Status Macros
+ * @{
+ */
+	#define RCC_OK                0 /*!< Clock tree switched                        */
+	#define RCC_ERR_PARAM         1 /*!< PLL factors, bus clocks or preset out of range */
+	#define RCC_ERR_HSE_TIMEOUT   2 /*!< Crystal did not start, clocks unchanged    */
+	#define RCC_ERR_PLL_TIMEOUT   3 /*!< PLL did not lock, running from HSI         */
+	#define RCC_ERR_HOOK_FULL     4 /*!< RCC_CLOCK_HOOK_MAX hooks already registered */
+	#define RCC_ERR_BUSY          5 /*!< A hook refused the change, clocks unchanged */
+/** @} */ // end of RCC_STATUS_MACROS
+
+/**
+ * @defgroup RCC_PRESET_MACROS RCC Clock Preset Macros
+ * @brief Configurations for rcc_set_preset(), HSE presets need RCC_HSE_VALUE = 8 MHz.
+ * @{
+ */
+	#define RCC_PRESET_168MHZ     0 /*!< HSE+PLL, HCLK 168, PCLK1 42, PCLK2 84 MHz, 5 WS       */
+	#define RCC_PRESET_84MHZ      1 /*!< HSE+PLL, HCLK 84, PCLK1 42, PCLK2 84 MHz, 2 WS, VOS 2  */
+	#define RCC_PRESET_16MHZ      2 /*!< HSI, PLL and HSE off, all buses 16 MHz, 0 WS, VOS 2    */
+	#define RCC_PRESET_COUNT      3
+/** @} */ // end of RCC_PRESET_MACROS
+
+/**
+ * @defgroup RCC_CLOCK_CHANGE_MACROS RCC Clock Change Phase Macros
+ * @brief Phase argument of @ref RCC_ClockHook_t
+ * @{
+ */
+	#define RCC_CLOCK_CHANGE_PRE   0 /*!< Clocks about to change: pause, or refuse if busy     */
+	#define RCC_CLOCK_CHANGE_POST  1 /*!< Clocks changed: recompute prescalers from rcc_get_*() */
+	#define RCC_CLOCK_CHANGE_ABORT 2 /*!< A later hook refused: undo PRE, clocks unchanged     */
+/** @} */ // end of RCC_CLOCK_CHANGE_MACROS
+
+/**
+ * @brief Clock change notification.
+ * @param Phase    @ref RCC_CLOCK_CHANGE_MACROS
+ * @param pContext Pointer given at registration
+ * @note  Runs in the context calling rcc_clock_config(), interrupts enabled.
+ *        A PRE hook must not wait for a transfer: it returns RCC_ERR_BUSY and
+ *        the change is refused, hooks that already accepted get ABORT.
+ * @return RCC_OK, or RCC_ERR_BUSY from PRE to refuse. Ignored for POST/ABORT.
+ */
+typedef uint8_t (*RCC_ClockHook_t)(uint8_t Phase, void *pContext);
+
+/**
+ * @defgroup RCC_Config_Struct RCC Configuration Structure definition
+ * @{
+ */
+typedef struct
+{
+    uint8_t  RCC_SYSCLK_SOURCE;  /*!< Refer @ref RCC_SYSCLK_SOURCE_MACROS                       */
+    uint8_t  RCC_PLL_SOURCE;     /*!< Refer @ref RCC_PLL_SOURCE_MACROS, PLL only                */
+    uint8_t  RCC_PLL_M;          /*!< 2..63, VCO input = source / M must be 1..2 MHz            */
+    uint16_t RCC_PLL_N;          /*!< 50..432, VCO output = input * N must be 100..432 MHz     */
+    uint8_t  RCC_PLL_P;          /*!< 2, 4, 6 or 8, SYSCLK = VCO / P                            */
+    uint8_t  RCC_PLL_Q;          /*!< 2..15, 48 MHz domain = VCO / Q                            */
+    uint8_t  RCC_AHB_PRESC;      /*!< Refer @ref RCC_AHB_PRESC_MACROS                           */
+    uint8_t  RCC_APB1_PRESC;     /*!< Refer @ref RCC_APB_PRESC_MACROS, PCLK1 max 42 MHz         */
+    uint8_t  RCC_APB2_PRESC;     /*!< Refer @ref RCC_APB_PRESC_MACROS, PCLK2 max 84 MHz         */
+} RCC_Config_t;
+/** @} */ // End of RCC_Config_t Structure Definition
+
+/**
+ * @defgroup RCC_API_PROTOTYPES RCC API Prototypes
+ * @{
+ */
+
+/**
+ * @brief   Switch the clock tree to a new configuration.
+ *
+ * Sequence:
+ *  1. Check the PLL factors and the resulting bus clocks
+ *  2. Start HSE if used
+ *  3. Raise the flash latency if HCLK goes up
+ *  4. Run from HSI while the regulator scale and the PLL are reprogrammed
+ *  5. APB prescalers to /16, AHB prescaler, switch SYSCLK, final APB prescalers
+ *  6. Lower the flash latency if HCLK went down, stop unused oscillators
+ *
+ * @param   pConfig : Clock configuration.
+ * @note    Hooks registered with rcc_clock_hook_register() run before step 2
+ *          and after step 6; other timings derived from the old clocks are
+ *          not updated. If a hook refuses PRE nothing is switched and
+ *          RCC_ERR_BUSY is returned; retry once the transfer is done.
+ * @return  uint8_t : @ref RCC_STATUS_MACROS
+ */
+uint8_t rcc_clock_config(const RCC_Config_t *pConfig);
+
+/**
+ * @brief   Switch to a predefined configuration with rcc_clock_config().
+ * @param   Preset : @ref RCC_PRESET_MACROS
+ * @return  uint8_t : @ref RCC_STATUS_MACROS
+ */
+uint8_t rcc_set_preset(uint8_t Preset);
+
+/**
+ * @brief   Call a hook before and after every clock change.
+ *
+ * Drivers whose timing depends on a bus clock (SPI baud rate, UART BRR,
+ * timer prescalers, SysTick reload) register here so their rates stay
+ * correct across rcc_clock_config()/rcc_set_preset().
+ *
+ * @param   Hook     : Function called with RCC_CLOCK_CHANGE_PRE, then RCC_CLOCK_CHANGE_POST
+ *                     or RCC_CLOCK_CHANGE_ABORT.
+ * @param   pContext : Passed back to the hook (e.g. a driver handle).
+ * @return  uint8_t : RCC_OK or RCC_ERR_HOOK_FULL
+ */
+uint8_t rcc_clock_hook_register(RCC_ClockHook_t Hook, void *pContext);
+
+/**
+ * @brief   Remove a hook registered with the same Hook/pContext pair.
+ * @param   Hook     : Registered function.
+ * @param   pContext : Registered context.
+ * @return  None
+ */
+void rcc_clock_hook_unregister(RCC_ClockHook_t Hook, void *pContext);
+
+/**
+ * @brief   Current SYSCLK frequency, decoded from the RCC registers.
+ * @return  uint32_t : Hz
+ */
+uint32_t rcc_get_sysclk(void);
+
+/**
+ * @brief   Current AHB clock (core, DMA, GPIO, SysTick).
+ * @return  uint32_t : Hz
+ */
+uint32_t rcc_get_hclk(void);
+
+/**
+ * @brief   Current APB1 clock (SPI2, SPI3, I2C, USART2..5, TIM2..7).
+ * @return  uint32_t : Hz
+ */
+uint32_t rcc_get_pclk1(void);
+
+/**
+ * @brief   Current APB2 clock (SPI1, SYSCFG, USART1/6, TIM1/8..11).
+ * @return  uint32_t : Hz
+ */
+uint32_t rcc_get_pclk2(void);
+
+/**
+ * @brief   Clock of the bus a peripheral sits on.
+ * @param   RccId : @ref RCC_PERIPH_ID_MACROS of the peripheral.
+ * @return  uint32_t : Hz
+ */
+uint32_t rcc_get_bus_clock(uint8_t RccId);
+
+/** @} */ // End of RCC_API_PROTOTYPES
+
+/** @} */ // End of RCC_Driver
+#endif /* INC_STM32F407XX_RCC_H_ */
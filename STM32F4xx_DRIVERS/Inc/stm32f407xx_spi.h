@@ -8,6 +8,9 @@
 #ifndef INC_STM32F407XX_SPI_H_
 #define INC_STM32F407XX_SPI_H_
 #include "stm32f407xx.h"
+#include "stm32f407xx_dma.h"
+#include "stm32f407xx_nvic.h"
+#include "stm32f407xx_rcc.h"
 
 /**
  * @defgroup SPI_DRIVER_DEVELOPEMNT SPI Driver
@@ -126,8 +129,30 @@
 	 */
 		#define SPI_CRC_ENABLE    1 /*!< CRC calculation enabled  */
 		#define SPI_CRC_DISABLE   0 /*!< CRC calculation disabled */
+		#define SPI_CRC_POLYNOMIAL_DEFAULT  0x0007U /*!< CRCPR reset value, CRC-8 x^8+x^2+x+1 */
 	/** @} */   // end of SPI_CRC_MACROS
 
+	/**
+	 * @defgroup SPI_HD_DIR_MACROS SPI Half-Duplex Direction Macros
+	 * @ingroup SPI_CONFIG_MACROS
+	 * @brief Data line direction in @ref SPI_BUS_MODE_HALF_DUPLEX (BIDIOE)
+	 * @{
+	 */
+		#define SPI_HD_DIR_RX    0 /*!< Receive only, a master clocks as long as SPE=1 */
+		#define SPI_HD_DIR_TX    1 /*!< Transmit only                                  */
+	/** @} */   // end of SPI_HD_DIR_MACROS
+
+	/**
+	 * @defgroup SPI_FRAME_FORMAT_MACROS SPI Frame Format Macros
+	 * @ingroup SPI_CONFIG_MACROS
+	 * @brief Frame format selected with FRF in SPI_CR2
+	 * @{
+	 */
+		#define SPI_FRAME_FORMAT_MOTOROLA  0 /*!< Motorola SPI, CPOL/CPHA/NSS/bit order as configured */
+		#define SPI_FRAME_FORMAT_TI        1 /*!< TI SSP: one NSS pulse per frame, CPOL/CPHA/LSBFIRST,
+		                                          SSM/SSI and SSOE are ignored by the hardware        */
+	/** @} */   // end of SPI_FRAME_FORMAT_MACROS
+
 /** @} */   // end of SPI_CONFIG_MACROS
 
 
@@ -150,24 +175,202 @@ typedef struct
     uint8_t SPI_BIT_ORDER;    /*!< MSB-first or LSB-first transmission.        Refer @ref SPI_BIT_ORDER_MACROS          */
     uint8_t SPI_SSOE;         /*!< SSO output enable (Master mode only).       Refer @ref SPI_SSOE_MACROS               */
     uint8_t SPI_CRC_EN;       /*!< CRC calculation enable/disable.             Refer @ref SPI_CRC_MACROS                */
+    uint16_t SPI_CRC_POLYNOMIAL; /*!< CRC polynomial written to CRCPR, 0 keeps the reset value 0x0007          */
+    uint8_t SPI_FRAME_FORMAT; /*!< Motorola or TI frame format.                Refer @ref SPI_FRAME_FORMAT_MACROS       */
 } SPIx_Config_t;
 /** @} */ // End of SPIx_Config_t Structure Definition
 
+/**
+ * @defgroup SPI_Config_Image SPI Configuration Image
+ * @brief Register values of an @ref SPIx_Config_t, built once and written as a whole
+ *
+ * Switching a peripheral between devices with SPIx_Init() costs one clear and
+ * one set per field. An image holds the finished CR1/CR2/CRCPR values so that
+ * SPIx_ApplyConfig() can switch with one store per register. Images can be
+ * built at run time with SPIx_CompileConfig() or as constants with
+ * SPI_CONFIG_IMAGE_INIT().
+ * @{
+ */
+typedef struct
+{
+    uint16_t CR1;      /*!< SPI_CR1 value, SPE and CRCNEXT always 0         */
+    uint16_t CR2;      /*!< Configuration bits of SPI_CR2 (SSOE, FRF)       */
+    uint16_t CRCPR;    /*!< CRC polynomial, written only when CRCEN is set  */
+} SPIx_ConfigImage_t;
+
+/** CR2 bits owned by the configuration image, the others are left untouched */
+#define SPI_CONFIG_CR2_MASK   ((1U << SPI_CR2_SSOE_Pos) | (1U << SPI_CR2_FRF_Pos))
+
+/** CR1 bits the TI frame format does not use, kept 0 in a TI image */
+#define SPI_CONFIG_CR1_TI_UNUSED  ((1U << SPI_CR1_CPOL_Pos) | (1U << SPI_CR1_CPHA_Pos) | (1U << SPI_CR1_LSBFIRST_Pos) \
+                                  | (1U << SPI_CR1_SSM_Pos) | (1U << SPI_CR1_SSI_Pos))
+
+/**
+ * @brief SPI_CR1 value for a configuration. With software slave management a
+ *        master also gets SSI=1, otherwise NSS reads low and raises MODF.
+ */
+#define SPI_CONFIG_CR1(DEVICE_MODE, BUS_MODE, CLOCK_SPEED, CPOL, CPHA, FRAME_SIZE, BIT_ORDER, SSM, CRC_EN) \
+	((uint16_t)( ((uint32_t)(DEVICE_MODE) << SPI_CR1_MSTR_Pos)                                        \
+	           | ((uint32_t)((BUS_MODE) == SPI_BUS_MODE_HALF_DUPLEX) << SPI_CR1_BIDIMODE_Pos)          \
+	           | ((uint32_t)((BUS_MODE) == SPI_BUS_MODE_SIMPLEX_RX) << SPI_CR1_RXONLY_Pos)             \
+	           | ((uint32_t)(CLOCK_SPEED) << SPI_CR1_BR_Pos)                                           \
+	           | ((uint32_t)(CPOL) << SPI_CR1_CPOL_Pos)                                                \
+	           | ((uint32_t)(CPHA) << SPI_CR1_CPHA_Pos)                                                \
+	           | ((uint32_t)(FRAME_SIZE) << SPI_CR1_DFF_Pos)                                           \
+	           | ((uint32_t)(BIT_ORDER) << SPI_CR1_LSBFIRST_Pos)                                       \
+	           | ((uint32_t)(SSM) << SPI_CR1_SSM_Pos)                                                  \
+	           | ((uint32_t)((SSM) && (DEVICE_MODE) == SPI_DEVICE_MODE_MASTER) << SPI_CR1_SSI_Pos)     \
+	           | ((uint32_t)(CRC_EN) << SPI_CR1_CRCEN_Pos) ))
+
+/** @brief SPI_CR2 configuration bits, see @ref SPI_CONFIG_CR2_MASK */
+#define SPI_CONFIG_CR2(SSOE, FRAME_FORMAT)                                             \
+	((uint16_t)((FRAME_FORMAT) == SPI_FRAME_FORMAT_TI ? (1U << SPI_CR2_FRF_Pos)     \
+	                                                  : ((uint32_t)(SSOE) << SPI_CR2_SSOE_Pos)))
+
+/**
+ * @brief Constant initialiser of an @ref SPIx_ConfigImage_t, arguments in
+ *        @ref SPIx_Config_t order. A POLYNOMIAL of 0 selects the default.
+ *
+ * @code
+ * static const SPIx_ConfigImage_t flash_cfg = SPI_CONFIG_IMAGE_INIT(
+ *     SPI_DEVICE_MODE_MASTER, SPI_BUS_MODE_FULL_DUPLEX, SPI_CLOCK_SPEED_BY_4,
+ *     SPI_CPOL_LOW, SPI_CPHA_FIRST_EDGE, SPI_FRAME_SIZE_8_BITS, SPI_SSM_SETTING_EN,
+ *     SPI_BIT_ORDER_MSB_FIRST, SPI_SSOE_DI, SPI_CRC_DISABLE, 0, SPI_FRAME_FORMAT_MOTOROLA);
+ * @endcode
+ */
+#define SPI_CONFIG_IMAGE_INIT(DEVICE_MODE, BUS_MODE, CLOCK_SPEED, CPOL, CPHA, FRAME_SIZE, SSM, BIT_ORDER, SSOE, CRC_EN, POLYNOMIAL, FRAME_FORMAT) \
+	{ .CR1 = (uint16_t)(SPI_CONFIG_CR1(DEVICE_MODE, BUS_MODE, CLOCK_SPEED, CPOL, CPHA, FRAME_SIZE, BIT_ORDER, SSM, CRC_EN)          \
+	                    & ((FRAME_FORMAT) == SPI_FRAME_FORMAT_TI ? ~SPI_CONFIG_CR1_TI_UNUSED : 0xFFFFU)),                         \
+	  .CR2 = SPI_CONFIG_CR2(SSOE, FRAME_FORMAT),                                                                                  \
+	  .CRCPR = (uint16_t)((POLYNOMIAL) ? (POLYNOMIAL) : SPI_CRC_POLYNOMIAL_DEFAULT) }
+/** @} */ // End of SPI_Config_Image
+
+
+/**
+ * @defgroup SPI_STATE_MACROS SPI Transfer State Macros
+ * @brief State of an interrupt driven transfer kept in @ref SPIx_Handle_t
+ * @{
+ */
+	#define SPI_STATE_READY          0 /*!< No transfer in progress, handle can accept a new one */
+	#define SPI_STATE_BUSY_IN_TX     1 /*!< Interrupt driven transmission in progress */
+	#define SPI_STATE_BUSY_IN_RX     2 /*!< Interrupt driven reception in progress */
+/** @} */ // end of SPI_STATE_MACROS
+
+/**
+ * @brief Returned by the non-blocking start APIs, next to the busy states,
+ *        when the request itself is refused (zero or bad length, unknown
+ *        instance, wrong bus mode). Nothing is started and no event follows.
+ */
+#define SPI_NOT_STARTED          0xFFU
+
+/**
+ * @defgroup SPI_EVENT_MACROS SPI Application Event Macros
+ * @brief Events reported to the application through @ref SPIx_EventCallback_t
+ * @{
+ */
+	#define SPI_EVENT_TX_CMPLT       1 /*!< Last frame of the TX buffer was written to DR */
+	#define SPI_EVENT_RX_CMPLT       2 /*!< Last frame of the RX buffer was read from DR  */
+	#define SPI_EVENT_OVR_ERR        3 /*!< Overrun detected and cleared during reception */
+	#define SPI_EVENT_TXRX_CMPLT     4 /*!< Full-duplex DMA exchange finished             */
+	#define SPI_EVENT_TX_HALF_CMPLT  5 /*!< DMA has moved the first half of the TX buffer */
+	#define SPI_EVENT_RX_HALF_CMPLT  6 /*!< DMA has filled the first half of the RX buffer */
+	#define SPI_EVENT_DMA_ERR        7 /*!< DMA transfer error, the transfer was aborted  */
+	#define SPI_EVENT_CRC_ERR        8 /*!< Received CRC mismatch, reported before RX_CMPLT/TXRX_CMPLT */
+	#define SPI_EVENT_FRE_ERR        9 /*!< TI frame format error (slave saw NSS pulse mid-frame), cleared */
+/** @} */ // end of SPI_EVENT_MACROS
+
+/**
+ * @defgroup SPI_ERROR_MACROS SPI Error Code Macros
+ * @brief Result of blocking transfers
+ * @{
+ */
+	#define SPI_ERROR_NONE           0 /*!< Transfer completed                         */
+	#define SPI_ERROR_CRC            1 /*!< CRCERR was set at the end of the transfer   */
+	#define SPI_ERROR_DMA            2 /*!< DMA transfer error, transfer aborted        */
+	#define SPI_ERROR_NOT_STARTED    3 /*!< Handle busy, length or bus mode rejected, nothing sent */
+/** @} */ // end of SPI_ERROR_MACROS
+
+/**
+ * @defgroup SPI_DMA_XFER_MACROS SPI DMA Transfer Type Macros
+ * @brief Kind of DMA transfer owning the handle, decides which events are reported
+ * @{
+ */
+	#define SPI_DMA_XFER_NONE        0 /*!< No DMA transfer running            */
+	#define SPI_DMA_XFER_TX          1 /*!< SPIx_Transmit_DMA()                */
+	#define SPI_DMA_XFER_RX          2 /*!< SPIx_Receive_DMA()                 */
+	#define SPI_DMA_XFER_TXRX        3 /*!< SPIx_TransmitReceive_DMA()         */
+	#define SPI_DMA_XFER_RING        4 /*!< SPIx_SlaveRing_Start(), circular   */
+	#define SPI_DMA_XFER_HD          5 /*!< SPIx_HalfDuplex_TransmitReceive_DMA() */
+/** @} */ // end of SPI_DMA_XFER_MACROS
+
+struct SPIx_Handle;
+
+/**
+ * @brief Application callback invoked from @ref SPIx_IRQHandling().
+ * @param pSPI_Handle Handle on which the event occurred
+ * @param AppEvent    One of @ref SPI_EVENT_MACROS
+ * @note  Runs in interrupt context, keep it short.
+ */
+typedef void (*SPIx_EventCallback_t)(struct SPIx_Handle *pSPI_Handle, uint8_t AppEvent);
 
 /**
  * @defgroup SPI_Handle_Struct SPI Handle Structure definition
  * @brief SPI handle structure
- * @note  Contains SPI instance and its configuration
+ * @note  Contains SPI instance, its configuration and the interrupt transfer context.
+ *        Zero-initialising the handle (memset) leaves it in @ref SPI_STATE_READY.
  * @{
  */
-typedef struct
+typedef struct SPIx_Handle
 {
     SPIx_RegDef_t *pSPIx;   	/*!< Pointer to SPI peripheral base address */
     SPIx_Config_t  SPI_CONFIG; 	/*!< SPI configuration settings */
 
+    const uint8_t *pTxBuffer;   /*!< Next byte to transmit, NULL sends dummy frames  */
+    uint8_t       *pRxBuffer;   /*!< Next location to store received data            */
+    uint32_t       TxLen;       /*!< Bytes left to transmit                          */
+    uint32_t       RxLen;       /*!< Bytes left to receive                           */
+    volatile uint8_t TxState;   /*!< @ref SPI_STATE_MACROS                           */
+    volatile uint8_t RxState;   /*!< @ref SPI_STATE_MACROS                           */
+    volatile uint8_t DmaXfer;   /*!< @ref SPI_DMA_XFER_MACROS                        */
+    SPIx_EventCallback_t AppEventCallback; /*!< Optional, called on @ref SPI_EVENT_MACROS */
+    void          *pAppContext; /*!< Free for the callback owner (e.g. the SPI bus layer) */
+    uint8_t       *pHdRxBuffer; /*!< Half-duplex: receive phase queued behind the TX phase */
+    uint32_t       HdRxLen;     /*!< Half-duplex: bytes of the queued receive phase     */
+    uint32_t       HdSckCycles; /*!< Half-duplex: CPU cycles per SCK, for the clock stop */
+    uint32_t       MaxBaudHz;   /*!< SCK limit kept across clock changes, see SPIx_RegisterClockHook() */
+    uint8_t        BusOwned;    /*!< Set by spi_bus_init(): baud rate follows the bus devices */
 } SPIx_Handle_t;
 /** @} */ // End of SPIx_Handle_t Structure Definition
 
+/**
+ * @defgroup SPI_SlaveRing_Struct SPI Slave RX Ring Structure definition
+ * @brief Slave reception into a ring buffer fed by a circular DMA stream
+ *
+ * The RX stream runs in circular mode over @ref SPIx_SlaveRing_t::pBuffer and is
+ * never stopped, so no frame is lost between transfers. Half/complete
+ * interrupts only advance WriteTotal; the application reads the data in place
+ * with SPIx_SlaveRing_Peek()/SPIx_SlaveRing_Consume().
+ *
+ * A master can use the ring too: the circular TX stream keeps TXE fed, so the
+ * clock never stops and frames run back to back, e.g. a TI-mode ADC streaming
+ * one conversion per NSS pulse.
+ * @{
+ */
+typedef struct
+{
+    SPIx_Handle_t *pSPI_Handle;           /*!< Slave handle the ring runs on                     */
+    uint8_t       *pBuffer;               /*!< Ring storage, half-word aligned for 16-bit frames */
+    uint16_t       Size;                  /*!< Ring size in bytes                                */
+    uint8_t        FrameBytes;            /*!< 1 or 2, from DFF at start                         */
+    volatile uint32_t WriteTotal;         /*!< Bytes received up to the last HT/TC boundary      */
+    uint32_t       ReadTotal;             /*!< Bytes consumed by the application                 */
+    volatile uint32_t OverrunCount;       /*!< SPI OVR events (frame lost in the SPI)            */
+    volatile uint32_t UnderrunCount;      /*!< SPI UDR events, only raised in I2S slave mode     */
+    volatile uint32_t RingOverflowCount;  /*!< Application fell a full ring behind, data dropped */
+    volatile uint32_t FrameErrorCount;    /*!< SPI FRE events (TI frame format, slave)           */
+} SPIx_SlaveRing_t;
+/** @} */ // End of SPIx_SlaveRing_t Structure Definition
+
 /**
  * @defgroup SPI_STATUS_FLAG_MACROS SPI Status Flag Macros
  * @brief SPI Status Flag macros
@@ -270,6 +473,33 @@ typedef struct
  */
 void SPIx_Init(SPIx_Handle_t *pSPI_Handle);
 
+/**
+ * @brief   Translate a configuration into its register image.
+ *
+ * @param   pConfig : Configuration to translate.
+ * @param   pImage  : Image to fill.
+ *
+ * @note    Pure computation, no register access. Call it once per device
+ *          (e.g. at registration) and switch with SPIx_ApplyConfig().
+ *
+ * @return  None
+ */
+void SPIx_CompileConfig(const SPIx_Config_t *pConfig, SPIx_ConfigImage_t *pImage);
+
+/**
+ * @brief   Load a configuration image into the peripheral.
+ *
+ * @param   pSPIx  : Pointer to the SPI peripheral base address.
+ * @param   pImage : Image from SPIx_CompileConfig() or SPI_CONFIG_IMAGE_INIT().
+ *
+ * @note    The peripheral clock must be enabled and no transfer may be in
+ *          progress (BSY=0). SPE is cleared first if set and is left cleared,
+ *          as after SPIx_Init(). CR1 is written with a single store.
+ *
+ * @return  None
+ */
+void SPIx_ApplyConfig(SPIx_RegDef_t *pSPIx, const SPIx_ConfigImage_t *pImage);
+
 /**
  * @brief   Resets the SPI peripheral registers to their default reset values.
  *
@@ -299,6 +529,78 @@ void SPIx_DeInit(SPIx_RegDef_t *pSPIx);
  */
 void SPIx_Peri_Control(SPIx_RegDef_t *pSPIx, uint8_t EN_DI);
 
+/**
+ * @brief   Restart the hardware CRC calculation (clears TXCRCR/RXCRCR).
+ *
+ * @param   pSPIx : Pointer to the SPI peripheral base address.
+ *
+ * @note    Toggles CRCEN. All CRC aware transfer APIs call it on entry so each
+ *          transfer carries the CRC of its own frames only. CRCEN may only be
+ *          written with SPE=0: if SPE is set, the function waits for BSY=0,
+ *          clears SPE around the toggle and sets it again (with SSOE the NSS
+ *          output is released for that moment).
+ *
+ * @return  None
+ */
+void SPIx_ResetCRC(SPIx_RegDef_t *pSPIx);
+
+/**
+ * @brief   Current SCK frequency of an SPI master.
+ *
+ * @param   pSPIx : Pointer to the SPI peripheral base address.
+ *
+ * @note    Derived from BR and the live APB clock of the instance
+ *          (SPI1: PCLK2, SPI2/SPI3: PCLK1), see rcc_get_bus_clock().
+ *
+ * @return  uint32_t : Baud rate in Hz, 0 for an unknown instance.
+ */
+uint32_t SPIx_GetBaudRate(SPIx_RegDef_t *pSPIx);
+
+/**
+ * @brief   Fastest clock divider that keeps SCK at or below a limit.
+ *
+ * @param   pSPIx     : Pointer to the SPI peripheral base address.
+ * @param   MaxBaudHz : Highest SCK frequency the device accepts.
+ *
+ * @return  uint8_t : @ref SPI_CLOCK_SPEED_MACROS for SPIx_Config_t::SPI_CLOCK_SPEED,
+ *                    SPI_CLOCK_SPEED_BY_256 if even that is above the limit.
+ */
+uint8_t SPIx_ComputeClockSpeed(SPIx_RegDef_t *pSPIx, uint32_t MaxBaudHz);
+
+/**
+ * @brief   Reprogram BR for SCK at or below a limit, at the current APB clock.
+ *
+ * @param   pSPIx     : Pointer to the SPI peripheral base address.
+ * @param   MaxBaudHz : Highest SCK frequency the device accepts.
+ *
+ * @note    Waits for BSY=0 and clears SPE around the BR write, SPE is restored.
+ *          Do not call while a transfer is in progress.
+ *
+ * @return  uint32_t : Resulting baud rate in Hz.
+ */
+uint32_t SPIx_SetBaudRate(SPIx_RegDef_t *pSPIx, uint32_t MaxBaudHz);
+
+/**
+ * @brief   Keep the SCK of a master at or below a limit across clock changes.
+ *
+ * Registers the handle with rcc_clock_hook_register(). Before a change the
+ * hook refuses it (rcc_clock_config() returns RCC_ERR_BUSY) while an
+ * interrupt/DMA transfer runs or BSY=1; after it, BR and
+ * SPI_CONFIG.SPI_CLOCK_SPEED are recomputed from the new APB clock.
+ * BR is also set right away for the current clock.
+ *
+ * @param   pSPI_Handle : Handle set up with SPIx_Init().
+ * @param   MaxBaudHz   : Highest SCK frequency the device accepts.
+ *
+ * @note    Not for a handle attached to an SPI bus: the bus reloads a per-device
+ *          image on every transaction and recompiles it from
+ *          SPI_BusDevice_t::MaxSckHz in its own hook (see spi_bus_init()).
+ *
+ * @return  uint8_t : @ref RCC_STATUS_MACROS, RCC_OK if registered,
+ *                    RCC_ERR_PARAM for a handle owned by an SPI bus.
+ */
+uint8_t SPIx_RegisterClockHook(SPIx_Handle_t *pSPI_Handle, uint32_t MaxBaudHz);
+
 /**
  * @brief   Reads the status of a specific SPI status flag.
  *
@@ -333,11 +635,341 @@ uint8_t SPIx_GetFlagStatus(SPIx_RegDef_t *pSPIx, uint32_t FlagName);
  *
  * @note  This is a blocking call. The function waits until all data
  *        has been transmitted before returning.
+ * @note  The frame size (DFF) is read once per call. With 16-bit frames the
+ *        buffer may be unaligned and an odd last byte is sent as the low
+ *        byte of a final frame.
+ * @note  With CRC enabled the CRC frame is appended after the last data frame.
  *
  * @retval None
  */
 void SPIx_SendData_Blocking(SPIx_RegDef_t *pSPIx, uint8_t* pData, uint32_t Len);
 
+/**
+ * @brief  Full-duplex blocking exchange.
+ *
+ * Writes the next frame as soon as TXE is set and reads as soon as RXNE is
+ * set, with at most two frames in flight (one shifting, one waiting in DR).
+ * The bus therefore runs without idle gaps even at SPI_CLOCK_SPEED_BY_2 and
+ * RXNE is always drained before OVR can occur.
+ *
+ * @param[in]  pSPI_Handle Pointer to the SPI handle (peripheral enabled).
+ * @param[in]  pTxBuffer   Data to send, NULL sends 0xFF dummy frames.
+ * @param[out] pRxBuffer   Received data, NULL discards the input.
+ * @param[in]  Len         Length in bytes. With 16-bit frames an odd trailing
+ *                         byte travels in the low byte of the last frame.
+ *
+ * @note  Buffers need no alignment, 16-bit frames are assembled byte-wise
+ *        (little endian, same as the DMA path).
+ * @note  With CRC enabled, CRCNEXT is set right after the last data frame,
+ *        the peer's CRC frame is received and discarded and CRCERR checked.
+ *
+ * @retval uint8_t @ref SPI_ERROR_MACROS
+ */
+uint8_t SPIx_TransmitReceive(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer,
+                          uint8_t *pRxBuffer, uint32_t Len);
+
+/**
+ * @brief  Start an interrupt driven transmission.
+ *
+ * Stores the buffer and length in the handle, marks it @ref SPI_STATE_BUSY_IN_TX
+ * and enables TXEIE. Every TXE interrupt then loads one frame from
+ * @ref SPIx_IRQHandling(). When the last frame has been written the handle
+ * returns to @ref SPI_STATE_READY and @ref SPI_EVENT_TX_CMPLT is reported.
+ *
+ * @param[in]  pSPI_Handle Pointer to the SPI handle.
+ * @param[in]  pTxBuffer   Data to transmit, must stay valid until completion.
+ * @param[in]  Len         Length in bytes.
+ *
+ * @note  The peripheral must already be enabled with SPIx_Peri_Control().
+ * @note  The last frame is still shifting out when TX_CMPLT fires. Calling
+ *        SPIx_Peri_Control(DISABLE) from the callback waits for BSY=0.
+ * @note  With CRC enabled CRCNEXT is set after the last frame and the CRC
+ *        frame is appended by hardware.
+ *
+ * @retval uint8_t @ref SPI_STATE_READY if started, the TX state found on entry
+ *         if busy, @ref SPI_NOT_STARTED for a zero @p Len.
+ */
+uint8_t SPIx_SendData_IT(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer, uint32_t Len);
+
+/**
+ * @brief  Start an interrupt driven reception.
+ *
+ * Enables RXNEIE and ERRIE and stores incoming frames in @p pRxBuffer.
+ * @ref SPI_EVENT_RX_CMPLT is reported after the last frame has been read.
+ *
+ * @param[in]  pSPI_Handle Pointer to the SPI handle.
+ * @param[out] pRxBuffer   Destination buffer, must stay valid until completion.
+ * @param[in]  Len         Length in bytes.
+ *
+ * @note  A full-duplex master only receives while it clocks. If no transmission
+ *        is running, dummy frames are sent automatically for the same length
+ *        (no TX_CMPLT event is reported for them). For a real full-duplex
+ *        exchange call this API first and SPIx_SendData_IT() right after.
+ * @note  With CRC enabled the peer's CRC frame is read after the data and
+ *        @ref SPI_EVENT_CRC_ERR is reported before RX_CMPLT on a mismatch.
+ *
+ * @retval uint8_t @ref SPI_STATE_READY if started, the RX state found on entry
+ *         if busy, @ref SPI_NOT_STARTED for a zero @p Len.
+ */
+uint8_t SPIx_ReceiveData_IT(SPIx_Handle_t *pSPI_Handle, uint8_t *pRxBuffer, uint32_t Len);
+
+/**
+ * @brief  SPI interrupt service routine body.
+ *
+ * Call it from the SPIx_IRQHandler of the instance owned by @p pSPI_Handle.
+ * Serves TXE, RXNE and OVR according to the enabled interrupt sources.
+ *
+ * @param[in]  pSPI_Handle Pointer to the SPI handle.
+ */
+void SPIx_IRQHandling(SPIx_Handle_t *pSPI_Handle);
+
+/**
+ * @brief  Set the NVIC priority of an SPI interrupt.
+ * @param  IRQNumber   @ref IRQ_NUMBER_MACROS (IRQ_NUM_SPI1/2/3)
+ * @param  IRQPriority @ref NVIC_IRQ_PRIORITY_LEVELS
+ */
+void SPIx_IRQ_Config(uint8_t IRQNumber, uint8_t IRQPriority);
+
+/**
+ * @brief  Enable or disable an SPI interrupt in the NVIC.
+ * @param  IRQNumber @ref IRQ_NUMBER_MACROS (IRQ_NUM_SPI1/2/3)
+ * @param  EN_DI     ENABLE or DISABLE
+ */
+void SPIx_IRQ_Control(uint8_t IRQNumber, uint8_t EN_DI);
+
+/**
+ * @brief  Transmit a buffer with DMA.
+ *
+ * Streams used (RM0090 request mapping):
+ *   - SPI1 : TX DMA2 Stream3 ch3, RX DMA2 Stream0 ch3
+ *   - SPI2 : TX DMA1 Stream4 ch0, RX DMA1 Stream3 ch0
+ *   - SPI3 : TX DMA1 Stream5 ch0, RX DMA1 Stream0 ch0
+ *
+ * Reports @ref SPI_EVENT_TX_HALF_CMPLT and @ref SPI_EVENT_TX_CMPLT.
+ *
+ * @param[in]  pSPI_Handle Pointer to the SPI handle (peripheral enabled).
+ * @param[in]  pTxBuffer   Data to transmit, half-word aligned for 16-bit frames.
+ * @param[in]  Len         Length in bytes, a multiple of the frame size,
+ *                         at most 65535 frames.
+ *
+ * @note  Route the stream interrupts with SPIx_DMA_IRQ_Config() and call
+ *        SPIx_DMA_TX_IRQHandling()/SPIx_DMA_RX_IRQHandling() from the
+ *        DMAx_StreamN_IRQHandler of the streams listed above.
+ *
+ * @retval uint8_t @ref SPI_STATE_READY if started, the TX state found on entry
+ *                 if busy, @ref SPI_NOT_STARTED for a zero @p Len, a length
+ *                 that does not fit the stream or an unknown instance.
+ */
+uint8_t SPIx_Transmit_DMA(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer, uint32_t Len);
+
+/**
+ * @brief  Receive a buffer with DMA.
+ *
+ * A full-duplex master clocks out 0xFF dummy frames from a fixed address on
+ * the TX stream. Reports @ref SPI_EVENT_RX_HALF_CMPLT and @ref SPI_EVENT_RX_CMPLT.
+ *
+ * @param[in]  pSPI_Handle Pointer to the SPI handle (peripheral enabled).
+ * @param[out] pRxBuffer   Destination, half-word aligned for 16-bit frames.
+ * @param[in]  Len         Length in bytes, a multiple of the frame size,
+ *                         at most 65535 frames.
+ *
+ * @retval uint8_t @ref SPI_STATE_READY if started, the busy state found on
+ *                 entry, or @ref SPI_NOT_STARTED as for SPIx_Transmit_DMA().
+ */
+uint8_t SPIx_Receive_DMA(SPIx_Handle_t *pSPI_Handle, uint8_t *pRxBuffer, uint32_t Len);
+
+/**
+ * @brief  Full-duplex exchange with DMA.
+ *
+ * @p pTxBuffer may be NULL to send dummy frames, @p pRxBuffer may be NULL to
+ * discard the received data. Reports @ref SPI_EVENT_RX_HALF_CMPLT and
+ * @ref SPI_EVENT_TXRX_CMPLT once the last frame has been received.
+ *
+ * With CRC enabled the DMA transfers carry data only: the SPI appends its CRC
+ * after NDTR frames and the received CRC is read in SPIx_DMA_RX_IRQHandling(),
+ * which reports @ref SPI_EVENT_CRC_ERR on a mismatch.
+ *
+ * @p Len is in bytes, a multiple of the frame size and at most 65535 frames.
+ *
+ * @retval uint8_t @ref SPI_STATE_READY if started, the busy state found on
+ *                 entry, or @ref SPI_NOT_STARTED as for SPIx_Transmit_DMA().
+ */
+uint8_t SPIx_TransmitReceive_DMA(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer,
+                                 uint8_t *pRxBuffer, uint32_t Len);
+
+/**
+ * @brief  Set the priority of and enable both DMA stream interrupts of an SPI.
+ * @param  pSPI_Handle Pointer to the SPI handle.
+ * @param  IRQPriority @ref NVIC_IRQ_PRIORITY_LEVELS
+ */
+void SPIx_DMA_IRQ_Config(SPIx_Handle_t *pSPI_Handle, uint8_t IRQPriority);
+
+/**
+ * @brief  TX stream interrupt body, call from the TX DMA stream IRQ handler.
+ * @param  pSPI_Handle Pointer to the SPI handle.
+ */
+void SPIx_DMA_TX_IRQHandling(SPIx_Handle_t *pSPI_Handle);
+
+/**
+ * @brief  RX stream interrupt body, call from the RX DMA stream IRQ handler.
+ * @param  pSPI_Handle Pointer to the SPI handle.
+ */
+void SPIx_DMA_RX_IRQHandling(SPIx_Handle_t *pSPI_Handle);
+
+/**
+ * @brief  Select the data line direction of a half-duplex (BIDIMODE=1) SPI.
+ *
+ * @param  pSPIx     Pointer to the SPI peripheral base address.
+ * @param  Direction @ref SPI_HD_DIR_MACROS
+ *
+ * @note   Clears SPE and leaves it cleared: a master in receive direction
+ *         starts clocking as soon as SPE is set. Call only with BSY=0.
+ */
+void SPIx_HalfDuplex_SetDirection(SPIx_RegDef_t *pSPIx, uint8_t Direction);
+
+/**
+ * @brief  Half-duplex command + response, blocking.
+ *
+ * Sends @p TxLen bytes with BIDIOE=1, waits for the line to go idle, turns
+ * the line around (BIDIOE=0) and reads @p RxLen bytes. A master stops its
+ * clock after the last frame: SPE is cleared one SPI clock after the
+ * second-to-last RXNE (RM0090 "Disabling the SPI"), so no extra frame is
+ * clocked. The SPI is left disabled after a receive phase.
+ *
+ * @param[in]  pSPI_Handle Handle in @ref SPI_BUS_MODE_HALF_DUPLEX, CRC disabled.
+ * @param[in]  pTxBuffer   Command bytes.
+ * @param[in]  TxLen       Command length in bytes, 0 skips the transmit phase.
+ * @param[out] pRxBuffer   Response bytes.
+ * @param[in]  RxLen       Response length in bytes, 0 skips the receive phase.
+ *
+ * @note   A master masks interrupts from the second-to-last RXNE until SPE
+ *         is cleared, about one SCK period, and times that wait with the DWT
+ *         cycle counter (enabled by the call).
+ *
+ * @retval uint8_t @ref SPI_ERROR_NONE, or @ref SPI_ERROR_NOT_STARTED if the
+ *                 handle is not in @ref SPI_BUS_MODE_HALF_DUPLEX.
+ */
+uint8_t SPIx_HalfDuplex_TransmitReceive(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer,
+                                        uint32_t TxLen, uint8_t *pRxBuffer, uint32_t RxLen);
+
+/**
+ * @brief  Half-duplex command + response, interrupt driven.
+ *
+ * Same sequence as SPIx_HalfDuplex_TransmitReceive(). The line is turned
+ * around from the TXE interrupt of the last command frame (one frame time of
+ * BSY polling) and the clock is stopped from the RXNE interrupt of the
+ * second-to-last response frame. Reports @ref SPI_EVENT_RX_CMPLT, or
+ * @ref SPI_EVENT_TX_CMPLT when @p RxLen is 0.
+ *
+ * @note   The SPI interrupt latency must stay below one frame time for the
+ *         master to stop after exactly @p RxLen bytes.
+ *
+ * @retval uint8_t @ref SPI_STATE_READY if started, otherwise the busy state,
+ *                 or @ref SPI_NOT_STARTED when both lengths are 0 or the
+ *                 handle is not in @ref SPI_BUS_MODE_HALF_DUPLEX.
+ */
+uint8_t SPIx_HalfDuplex_TransmitReceive_IT(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer,
+                                           uint32_t TxLen, uint8_t *pRxBuffer, uint32_t RxLen);
+
+/**
+ * @brief  Half-duplex command + response with DMA.
+ *
+ * The TX stream sends the command; its completion interrupt turns the line
+ * around and starts the RX stream. Reports @ref SPI_EVENT_RX_CMPLT, or
+ * @ref SPI_EVENT_TX_CMPLT when @p RxLen is 0.
+ *
+ * @note   The clock is stopped from the RX stream completion interrupt, so a
+ *         master may clock a few frames past @p RxLen. They are drained and
+ *         discarded; use the blocking or IT variant for devices that react to
+ *         extra clocks.
+ * @note   @p TxLen and @p RxLen follow the SPIx_Transmit_DMA() length rules.
+ *
+ * @retval uint8_t @ref SPI_STATE_READY if started, the busy state found on
+ *                 entry, or @ref SPI_NOT_STARTED when both lengths are 0, a
+ *                 length does not fit the stream, the handle is not in
+ *                 @ref SPI_BUS_MODE_HALF_DUPLEX or the instance is unknown.
+ */
+uint8_t SPIx_HalfDuplex_TransmitReceive_DMA(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer,
+                                            uint32_t TxLen, uint8_t *pRxBuffer, uint32_t RxLen);
+
+/**
+ * @brief  Start slave reception into a circular-DMA ring buffer.
+ *
+ * The RX stream fills @p pBuffer in circular mode. The TX stream replays
+ * @p pTxBuffer in circular mode so a response is always pre-armed when the
+ * master starts clocking; with NULL the slave answers 0xFF. The response
+ * memory may be rewritten in place while running. ERRIE is enabled so OVR/UDR
+ * are counted by SPIx_SlaveRing_IRQHandling(). SPE is set last.
+ *
+ * @param[out] pRing       Ring state, owned by the driver until stopped.
+ * @param[in]  pSPI_Handle Slave handle, configured with SPIx_Init(), SPE=0.
+ * @param[in]  pBuffer     Ring storage.
+ * @param[in]  Size        Ring size in bytes: even, a multiple of 4 with
+ *                         16-bit frames, at most 65535 frames.
+ * @param[in]  pTxBuffer   Response replayed to the master, or NULL.
+ * @param[in]  TxLen       Response length in bytes, a multiple of the frame size.
+ *
+ * @note  Route both stream interrupts with SPIx_DMA_IRQ_Config() and call
+ *        SPIx_SlaveRing_DMA_IRQHandling() from both stream IRQ handlers
+ *        instead of SPIx_DMA_TX/RX_IRQHandling(). Enable the SPI IRQ and call
+ *        SPIx_SlaveRing_IRQHandling() from it.
+ *
+ * @retval uint8_t @ref SPI_STATE_READY if started, the busy state found on
+ *                 entry, or @ref SPI_NOT_STARTED for an invalid @p Size or
+ *                 @p TxLen or an instance without DMA streams.
+ */
+uint8_t SPIx_SlaveRing_Start(SPIx_SlaveRing_t *pRing, SPIx_Handle_t *pSPI_Handle, uint8_t *pBuffer,
+                             uint16_t Size, const uint8_t *pTxBuffer, uint16_t TxLen);
+
+/**
+ * @brief  Stop the ring: SPE, DMA requests and both streams off.
+ * @param  pRing Ring started with SPIx_SlaveRing_Start().
+ */
+void SPIx_SlaveRing_Stop(SPIx_SlaveRing_t *pRing);
+
+/**
+ * @brief  Get the oldest unread data without copying it.
+ *
+ * Returns the contiguous part only: when the unread data wraps around the end
+ * of the ring, consume this span and call again for the rest. If the
+ * application has fallen a full ring behind, the unread data is dropped,
+ * RingOverflowCount is incremented and 0 is returned.
+ *
+ * @param[in]  pRing  Running ring.
+ * @param[out] ppData Start of the span inside the ring buffer.
+ *
+ * @retval uint16_t Span length in bytes, 0 if nothing new.
+ */
+uint16_t SPIx_SlaveRing_Peek(SPIx_SlaveRing_t *pRing, const uint8_t **ppData);
+
+/**
+ * @brief  Release bytes returned by SPIx_SlaveRing_Peek().
+ * @param  pRing Running ring.
+ * @param  Len   Bytes to release, at most the span length.
+ */
+void SPIx_SlaveRing_Consume(SPIx_SlaveRing_t *pRing, uint16_t Len);
+
+/**
+ * @brief  Unread bytes in the ring, wrapped part included.
+ * @param  pRing Running ring.
+ * @retval uint32_t
+ */
+uint32_t SPIx_SlaveRing_Available(SPIx_SlaveRing_t *pRing);
+
+/**
+ * @brief  SPI interrupt body for a ring: counts and clears OVR, UDR and FRE.
+ * @param  pRing Running ring.
+ */
+void SPIx_SlaveRing_IRQHandling(SPIx_SlaveRing_t *pRing);
+
+/**
+ * @brief  DMA stream interrupt body for a ring, call from the TX and RX stream
+ *         IRQ handlers. Advances WriteTotal on HT/TC; on a transfer error the
+ *         ring is stopped and @ref SPI_EVENT_DMA_ERR is reported.
+ * @param  pRing Running ring.
+ */
+void SPIx_SlaveRing_DMA_IRQHandling(SPIx_SlaveRing_t *pRing);
+
 
 /** @} */ // End of SPI_API_PROTOTYPES
 
@@ -0,0 +1,183 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_spi_bus.h
+ * @author  Yuvraj Singh
+ * @brief   Multi-device SPI bus layer for STM32F407xx MCU
+ *
+ * This file contains:
+ *   - SPI bus device descriptor (per-device mode, baud, frame and chip-select)
+ *   - SPI bus transaction descriptor and fixed-size queue
+ *   - Prototypes of the bus APIs
+ *
+ * Several devices share one SPI peripheral. Each device carries its own
+ * CPOL/CPHA/baud/frame settings and a GPIO chip-select. Transactions are
+ * queued and executed back to back with DMA; the peripheral is only
+ * reconfigured when the next device's register image differs from the current one.
+ * Devices with a MaxSckHz limit get their divider recomputed after every
+ * clock change made through the RCC driver.
+ *
+ * @version 1.0
+ * @date    05-Dec-2025
+ ******************************************************************************
+ */
+
+#ifndef INC_STM32F407XX_SPI_BUS_H_
+#define INC_STM32F407XX_SPI_BUS_H_
+
+#include "stm32f407xx_spi.h"
+#include "stm32f407xx_gpio.h"
+
+/**
+ * @defgroup SPI_BUS_Driver SPI Bus Layer
+ * @brief    Queued multi-device access to one SPI peripheral
+ * @{
+ */
+
+/**
+ * @brief Depth of the transaction queue of every bus.
+ * @note  Can be overridden from the compiler command line.
+ */
+#ifndef SPI_BUS_QUEUE_LEN
+#define SPI_BUS_QUEUE_LEN   8
+#endif
+
+/**
+ * @brief Devices that can be registered on one bus.
+ * @note  Can be overridden from the compiler command line.
+ */
+#ifndef SPI_BUS_MAX_DEVICES
+#define SPI_BUS_MAX_DEVICES 4
+#endif
+
+/**
+ * @defgroup SPI_BUS_STATUS_MACROS SPI Bus Status Macros
+ * @{
+ */
+	#define SPI_BUS_OK               0 /*!< Transaction queued                */
+	#define SPI_BUS_ERR_QUEUE_FULL   1 /*!< No free slot, try again later     */
+	#define SPI_BUS_ERR_PARAM        2 /*!< NULL device, bad or odd length    */
+	#define SPI_BUS_ERR_DEVICE_FULL  3 /*!< SPI_BUS_MAX_DEVICES already registered */
+	#define SPI_BUS_ERR_HOOK_FULL    4 /*!< No free RCC clock change hook     */
+/** @} */ // end of SPI_BUS_STATUS_MACROS
+
+/**
+ * @brief SPI bus device descriptor.
+ *
+ * Describes one slave on the bus. Fields take the same values as the
+ * corresponding members of @ref SPIx_Config_t.
+ */
+typedef struct
+{
+    GPIOx_RegDef_t *pCSPort;   /*!< Chip-select port (GPIOA..GPIOI)                   */
+    uint8_t  CSPin;            /*!< Chip-select pin 0..15, active low                 */
+    uint8_t  SPI_CLOCK_SPEED;  /*!< @ref SPI_CLOCK_SPEED_MACROS, used when MaxSckHz is 0 */
+    uint32_t MaxSckHz;         /*!< Highest SCK in Hz, 0 keeps SPI_CLOCK_SPEED at any clock */
+    uint8_t  SPI_CPOL;         /*!< @ref SPI_CPOL_MACROS                               */
+    uint8_t  SPI_CPHA;         /*!< @ref SPI_CPHA_MACROS                               */
+    uint8_t  SPI_FRAME_SIZE;   /*!< @ref SPI_FRAME_SIZE_MACROS                         */
+    uint8_t  SPI_BIT_ORDER;    /*!< @ref SPI_BIT_ORDER_MACROS                          */
+    SPIx_ConfigImage_t Image;  /*!< Filled by spi_bus_device_init(), do not set        */
+} SPI_BusDevice_t;
+
+struct SPI_BusTransaction;
+
+/**
+ * @brief Completion callback of a transaction.
+ * @param pTransaction Copy of the transaction as queued
+ * @param Status       @ref SPI_ERROR_MACROS
+ * @note  Runs in the DMA interrupt. It may submit further transactions.
+ */
+typedef void (*SPI_BusDoneCallback_t)(const struct SPI_BusTransaction *pTransaction, uint8_t Status);
+
+/**
+ * @brief One full-duplex exchange with a device.
+ */
+typedef struct SPI_BusTransaction
+{
+    SPI_BusDevice_t *pDevice;       /*!< Target device                                */
+    const uint8_t   *pTxBuffer;     /*!< Data to send, NULL sends dummy frames        */
+    uint8_t         *pRxBuffer;     /*!< Received data, NULL discards it              */
+    uint32_t         Len;           /*!< Bytes, multiple of the frame, max 65535 frames */
+    SPI_BusDoneCallback_t pfDone;   /*!< Optional completion callback                 */
+    void            *pContext;      /*!< Free for the submitter                        */
+} SPI_BusTransaction_t;
+
+/**
+ * @brief SPI bus instance, one per SPI peripheral.
+ */
+typedef struct
+{
+    SPIx_Handle_t        *pSPI_Handle;                 /*!< Underlying SPI handle              */
+    SPI_BusTransaction_t  Queue[SPI_BUS_QUEUE_LEN];    /*!< Pending transactions, [Head] runs  */
+    volatile uint8_t      Head;                        /*!< Index of the running transaction   */
+    volatile uint8_t      Count;                       /*!< Transactions queued incl. running  */
+    volatile uint8_t      Busy;                        /*!< Queue[Head] is on the wire         */
+    volatile uint8_t      Status;                      /*!< Result collected for the running one */
+    const SPI_BusDevice_t *pActiveDevice;              /*!< Device the SPI is configured for   */
+    SPI_BusDevice_t      *pDevices[SPI_BUS_MAX_DEVICES]; /*!< Registered devices              */
+    uint8_t               DeviceCount;                 /*!< Entries used in pDevices           */
+    volatile uint8_t      Paused;                      /*!< Clock change in progress, no kicks */
+} SPI_Bus_t;
+
+/**
+ * @defgroup SPI_BUS_API_PROTOTYPES SPI Bus API Prototypes
+ * @{
+ */
+
+/**
+ * @brief   Attach a bus to an initialised SPI handle.
+ *
+ * @param   pBus        : Bus instance.
+ * @param   pSPI_Handle : Handle already set up with SPIx_Init() as a master
+ *                        with software slave management (SSM=1).
+ *
+ * @note    Takes over AppEventCallback/pAppContext of the handle. The DMA
+ *          stream interrupts must be routed with SPIx_DMA_IRQ_Config() and
+ *          the stream IRQ handlers must call SPIx_DMA_TX/RX_IRQHandling().
+ * @note    Registers an RCC clock change hook. It refuses a change while a
+ *          transaction runs (rcc_clock_config() returns RCC_ERR_BUSY),
+ *          otherwise holds the queue; after the change every device image is
+ *          recompiled and the queue resumes. The handle is marked
+ *          bus-owned, so SPIx_RegisterClockHook() refuses it.
+ *
+ * @return  uint8_t : SPI_BUS_OK or SPI_BUS_ERR_HOOK_FULL.
+ */
+uint8_t spi_bus_init(SPI_Bus_t *pBus, SPIx_Handle_t *pSPI_Handle);
+
+/**
+ * @brief   Register a device on a bus.
+ *
+ * Compiles the device settings, on top of the handle configuration, into the
+ * register image used when switching to the device, and configures the
+ * chip-select pin as output, deasserted (high). With MaxSckHz set the divider
+ * is the fastest one at or below that limit for the current APB clock.
+ *
+ * @param   pBus    : Bus instance, already attached with spi_bus_init().
+ * @param   pDevice : Device descriptor, must stay valid while the bus is used.
+ * @note    Call again after changing any setting of the device.
+ * @return  uint8_t : SPI_BUS_OK or SPI_BUS_ERR_DEVICE_FULL.
+ */
+uint8_t spi_bus_device_init(SPI_Bus_t *pBus, SPI_BusDevice_t *pDevice);
+
+/**
+ * @brief   Queue a transaction. Starts it immediately if the bus is idle.
+ *
+ * @param   pBus         : Bus instance.
+ * @param   pTransaction : Descriptor, copied into the queue. The buffers must
+ *                         stay valid until the completion callback.
+ *
+ * @return  uint8_t : @ref SPI_BUS_STATUS_MACROS
+ */
+uint8_t spi_bus_submit(SPI_Bus_t *pBus, const SPI_BusTransaction_t *pTransaction);
+
+/**
+ * @brief   Check whether all queued transactions have completed.
+ * @param   pBus : Bus instance.
+ * @return  uint8_t : 1 if idle, 0 otherwise.
+ */
+uint8_t spi_bus_is_idle(SPI_Bus_t *pBus);
+
+/** @} */ // End of SPI_BUS_API_PROTOTYPES
+
+/** @} */ // End of SPI_BUS_Driver
+#endif /* INC_STM32F407XX_SPI_BUS_H_ */
@@ -0,0 +1,115 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_dma.c
+ * @author  Yuvraj Singh Rathore
+ * @version 1.0
+ * @date    02-Dec-2025
+ * @brief   DMA stream driver source file for STM32F407xx MCU.
+ *
+ * @details
+ * Minimal stream level driver used by the peripheral drivers (SPI, ...) to
+ * move data without CPU involvement. It provides APIs for:
+ *
+ *  - Enabling the controller clock and stopping a stream
+ *  - Programming and starting a stream from a @ref DMAx_Config_t
+ *  - Reading and clearing the per-stream event flags
+ *
+ * @section DMA_API_Summary DMA Driver API Summary
+ *
+ * - DMAx_Init()         : Enable DMA clock, stop the stream
+ * - DMAx_Start()        : Program PAR/M0AR/NDTR/SxCR and enable the stream
+ * - DMAx_Stop()         : Disable the stream and wait for EN=0
+ * - DMAx_GetFlags()     : Read normalised stream flags
+ * - DMAx_ClearFlags()   : Clear stream flags
+ * - DMAx_GetCounter()   : Read NDTR
+ * - DMAx_GetIRQNumber() : NVIC IRQ number of a stream
+ *
+ * @see stm32f407xx_dma.h
+ ******************************************************************************
+ */
+
+#include "stm32f407xx_dma.h"
+
+/** Bit offset of the flag group of stream 0..3 inside LISR/HISR (same for 4..7) */
+static const uint8_t dma_flag_shift[4] = { 0, 6, 16, 22 };
+
+void DMAx_Init(DMAx_Handle_t *pDMA_Handle) {
+	/*1. Enable the controller clock */
+	if (pDMA_Handle->pDMAx == DMA1) {
+		DMA1_PCLK_EN();
+	} else if (pDMA_Handle->pDMAx == DMA2) {
+		DMA2_PCLK_EN();
+	}
+	/*2. A stream can only be programmed while EN=0 */
+	DMAx_Stop(pDMA_Handle);
+}
+
+void DMAx_Start(DMAx_Handle_t *pDMA_Handle, uint32_t PeriphAddr, uint32_t MemAddr,
+		uint16_t Count, uint32_t ITMask) {
+	DMA_Stream_RegDef_t *pStream = &pDMA_Handle->pDMAx->STREAM[pDMA_Handle->STREAM];
+	DMAx_Config_t *pCfg = &pDMA_Handle->DMA_CONFIG;
+
+	/*1. Stop the stream and clear the flags of the previous transfer */
+	DMAx_Stop(pDMA_Handle);
+	DMAx_ClearFlags(pDMA_Handle->pDMAx, pDMA_Handle->STREAM, DMA_FLAG_ALL);
+
+	/*2. Addresses and item count */
+	pStream->PAR = PeriphAddr;
+	pStream->M0AR = MemAddr;
+	pStream->NDTR = Count;
+
+	/*3. Direct mode (FIFO disabled): PSIZE is used on both sides */
+	pStream->FCR = 0;
+
+	/*4. Build the whole SxCR image and write it once.
+	 *   The IE bits sit one position below the matching flag bits. */
+	uint32_t cr = 0;
+	cr |= ((uint32_t) pCfg->DMA_CHANNEL << DMA_SxCR_CHSEL_Pos);
+	cr |= ((uint32_t) pCfg->DMA_PRIORITY << DMA_SxCR_PL_Pos);
+	cr |= ((uint32_t) pCfg->DMA_DATA_SIZE << DMA_SxCR_MSIZE_Pos);
+	cr |= ((uint32_t) pCfg->DMA_DATA_SIZE << DMA_SxCR_PSIZE_Pos);
+	cr |= ((uint32_t) pCfg->DMA_MEM_INC << DMA_SxCR_MINC_Pos);
+	cr |= ((uint32_t) pCfg->DMA_CIRCULAR << DMA_SxCR_CIRC_Pos);
+	cr |= ((uint32_t) pCfg->DMA_DIRECTION << DMA_SxCR_DIR_Pos);
+	cr |= (ITMask & (DMA_FLAG_DMEIF | DMA_FLAG_TEIF | DMA_FLAG_HTIF | DMA_FLAG_TCIF)) >> 1;
+	pStream->CR = cr;
+
+	/*5. Go */
+	pStream->CR = cr | (1U << DMA_SxCR_EN_Pos);
+}
+
+void DMAx_Stop(DMAx_Handle_t *pDMA_Handle) {
+	DMA_Stream_RegDef_t *pStream = &pDMA_Handle->pDMAx->STREAM[pDMA_Handle->STREAM];
+	pStream->CR &= ~(1U << DMA_SxCR_EN_Pos);
+	/** EN stays set until the current single transfer has finished */
+	while (pStream->CR & (1U << DMA_SxCR_EN_Pos));
+}
+
+uint8_t DMAx_GetFlags(DMA_RegDef_t *pDMAx, uint8_t Stream) {
+	uint32_t isr = (Stream < 4) ? pDMAx->LISR : pDMAx->HISR;
+	return (uint8_t) ((isr >> dma_flag_shift[Stream & 0x3]) & DMA_FLAG_ALL);
+}
+
+void DMAx_ClearFlags(DMA_RegDef_t *pDMAx, uint8_t Stream, uint8_t Flags) {
+	/** IFCR is write-1-to-clear, a plain write leaves the other streams untouched */
+	uint32_t mask = ((uint32_t) (Flags & DMA_FLAG_ALL)) << dma_flag_shift[Stream & 0x3];
+	if (Stream < 4) {
+		pDMAx->LIFCR = mask;
+	} else {
+		pDMAx->HIFCR = mask;
+	}
+}
+
+uint16_t DMAx_GetCounter(DMAx_Handle_t *pDMA_Handle) {
+	return (uint16_t) pDMA_Handle->pDMAx->STREAM[pDMA_Handle->STREAM].NDTR;
+}
+
+uint8_t DMAx_GetIRQNumber(DMA_RegDef_t *pDMAx, uint8_t Stream) {
+	static const uint8_t dma1_irq[8] = {
+		IRQ_NUM_DMA1_STREAM0, IRQ_NUM_DMA1_STREAM1, IRQ_NUM_DMA1_STREAM2, IRQ_NUM_DMA1_STREAM3,
+		IRQ_NUM_DMA1_STREAM4, IRQ_NUM_DMA1_STREAM5, IRQ_NUM_DMA1_STREAM6, IRQ_NUM_DMA1_STREAM7 };
+	static const uint8_t dma2_irq[8] = {
+		IRQ_NUM_DMA2_STREAM0, IRQ_NUM_DMA2_STREAM1, IRQ_NUM_DMA2_STREAM2, IRQ_NUM_DMA2_STREAM3,
+		IRQ_NUM_DMA2_STREAM4, IRQ_NUM_DMA2_STREAM5, IRQ_NUM_DMA2_STREAM6, IRQ_NUM_DMA2_STREAM7 };
+	return (pDMAx == DMA1) ? dma1_irq[Stream & 0x7] : dma2_irq[Stream & 0x7];
+}
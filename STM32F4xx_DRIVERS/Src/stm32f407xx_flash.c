@@ -0,0 +1,78 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_flash.c
+ * @author  Yuvraj Singh Rathore
+ * @version 1.0
+ * @date    16-Dec-2025
+ * @brief   Flash interface driver source file for STM32F407xx MCU.
+ *
+ * @details
+ * FLASH_ACR access for the clock driver and the application:
+ *
+ *  - Wait states, with read back so the new value is in effect on return
+ *  - Prefetch, instruction cache and data cache enables
+ *  - Cache reset, only ever done while the cache is disabled (RM0090)
+ *
+ * @section FLASH_API_Summary Flash Driver API Summary
+ *
+ * - flash_latency_for_hclk() : Wait states for an HCLK frequency
+ * - flash_set_latency()      : Program LATENCY
+ * - flash_get_latency()      : Read LATENCY
+ * - flash_art_config()       : Enable/disable prefetch, I-cache, D-cache
+ * - flash_art_get()          : Enabled ART features
+ * - flash_cache_reset()      : Invalidate both caches
+ *
+ * @see stm32f407xx_flash.h
+ ******************************************************************************
+ */
+
+#include "stm32f407xx_flash.h"
+
+#define FLASH_ACR_LATENCY_MASK  (0x7UL << FLASH_ACR_LATENCY_Pos)
+#define FLASH_ACR_CACHE_RST     ((1UL << FLASH_ACR_ICRST_Pos) | (1UL << FLASH_ACR_DCRST_Pos))
+
+uint8_t flash_latency_for_hclk(uint32_t Hclk) {
+	uint32_t ws = (Hclk == 0) ? 0 : (Hclk - 1U) / FLASH_WS_STEP_HZ;
+	return (uint8_t) ((ws > FLASH_LATENCY_MAX) ? FLASH_LATENCY_MAX : ws);
+}
+
+void flash_set_latency(uint8_t Latency) {
+	uint32_t acr = FLASH_IF->ACR & ~FLASH_ACR_LATENCY_MASK;
+	FLASH_IF->ACR = acr | ((uint32_t) (Latency & 0x7U) << FLASH_ACR_LATENCY_Pos);
+	/** The new latency must be in effect before the clock changes */
+	while (flash_get_latency() != (Latency & 0x7U));
+}
+
+uint8_t flash_get_latency(void) {
+	return (uint8_t) ((FLASH_IF->ACR & FLASH_ACR_LATENCY_MASK) >> FLASH_ACR_LATENCY_Pos);
+}
+
+void flash_art_config(uint32_t Features) {
+	uint32_t acr = FLASH_IF->ACR & ~(FLASH_ART_ALL | FLASH_ACR_CACHE_RST);
+
+	/** 1. Caches off; a reset is ignored while a cache is enabled */
+	FLASH_IF->ACR = acr | (Features & FLASH_ART_PREFETCH);
+
+	/** 2. Invalidate the caches about to be enabled */
+	uint32_t rst = 0;
+	if (Features & FLASH_ART_ICACHE) {
+		rst |= (1UL << FLASH_ACR_ICRST_Pos);
+	}
+	if (Features & FLASH_ART_DCACHE) {
+		rst |= (1UL << FLASH_ACR_DCRST_Pos);
+	}
+	if (rst) {
+		FLASH_IF->ACR = acr | (Features & FLASH_ART_PREFETCH) | rst;
+	}
+
+	/** 3. Release the reset and enable */
+	FLASH_IF->ACR = acr | (Features & FLASH_ART_ALL);
+}
+
+uint32_t flash_art_get(void) {
+	return FLASH_IF->ACR & FLASH_ART_ALL;
+}
+
+void flash_cache_reset(void) {
+	flash_art_config(flash_art_get());
+}
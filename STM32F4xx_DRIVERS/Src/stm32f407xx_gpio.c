@@ -21,15 +21,31 @@
  * @section GPIO_API_Summary GPIO Driver API Summary
  *
  * - gpio_pin_init()    : Configure a GPIO pin (mode, type, speed, pull, AF)
+ * - gpio_port_init_mask() : Configure several pins of a port, one write per register
+ * - gpio_port_apply_image()  : Apply a compile-time port image from a pin table
+ * - gpio_port_apply_images() : Apply the images of several ports
  * - gpio_port_deinit() : Reset an entire GPIO port
+ * - gpio_port_lock()   : Lock the configuration of pins until reset
+ * - gpio_port_get_locked() : Read which pins are locked
  * - gpio_read_pin()    : Read the logic level of a pin
  * - gpio_read_port()   : Read the 16-bit input state of a port
  * - gpio_write_pin()   : Write HIGH/LOW to a pin
  * - gpio_write_port()  : Write 16-bit value to a port
  * - gpio_toggle_pin()  : Toggle pin output level
+ * - gpio_set_pins()    : Drive several pins HIGH with one BSRR write
+ * - gpio_clear_pins()  : Drive several pins LOW with one BSRR write
+ * - gpio_write_pins_masked() : Update several pins with one BSRR write
+ * - gpio_toggle_pins() : Toggle several pins with one ODR read + BSRR write
  * - gpio_irq_config()  : Configure EXTI trigger type
  * - gpio_irq_control() : Enable/disable NVIC interrupt for GPIO EXTI line
  * - gpio_irq_clear()   : Clear EXTI pending flag
+ * - gpio_event_config() : Route a pin to an EXTI line in event mode (EMR)
+ * - gpio_wait_for_edge() : Sleep with WFE until a pin reaches a level
+ * - gpio_exti_software_trigger() : Raise an EXTI line from software (SWIER)
+ * - gpio_exti_register() : Attach a callback to an EXTI line
+ * - gpio_exti_dispatch() : Serve the pending lines of an EXTI vector
+ * - gpio_exti_capture_start()/stop() : Timestamp edges of EXTI lines
+ * - gpio_exti_capture_drain() : Read captured edges in bulk
  *
  * @see stm32f407xx_gpio.h
  ******************************************************************************
@@ -44,26 +60,11 @@ void gpio_pin_init(GPIOx_Handle_t *GPIOx_Handle) {
 	uint8_t gpio_output_type = GPIOx_Handle->GPIO_CONFIG.GPIO_OP_TYPE;
 	uint8_t gpio_pu_pd = GPIOx_Handle->GPIO_CONFIG.GPIO_PU_PD;
 	uint8_t gpio_alt_func = GPIOx_Handle->GPIO_CONFIG.GPIO_ALT_FUNC;
-	/*1. Enable the respective GPIO peripheral through RCC */
-	if (GPIOx_Handle->pGPIOx == GPIOA) {
-		GPIOA_PCLK_EN();
-	} else if (GPIOx_Handle->pGPIOx == GPIOB) {
-		GPIOB_PCLK_EN();
-	} else if (GPIOx_Handle->pGPIOx == GPIOC) {
-		GPIOC_PCLK_EN();
-	} else if (GPIOx_Handle->pGPIOx == GPIOD) {
-		GPIOD_PCLK_EN();
-	} else if (GPIOx_Handle->pGPIOx == GPIOE) {
-		GPIOE_PCLK_EN();
-	} else if (GPIOx_Handle->pGPIOx == GPIOF) {
-		GPIOF_PCLK_EN();
-	} else if (GPIOx_Handle->pGPIOx == GPIOG) {
-		GPIOG_PCLK_EN();
-	} else if (GPIOx_Handle->pGPIOx == GPIOH) {
-		GPIOH_PCLK_EN();
-	} else if (GPIOx_Handle->pGPIOx == GPIOI) {
-		GPIOI_PCLK_EN();
-	}
+	/*1. Enable the respective GPIO peripheral through RCC (AHB1ENR bit = port index) */
+	uint32_t port = GPIO_PORT_INDEX(GPIOx_Handle->pGPIOx);
+	if (port >= GPIO_PORT_COUNT)
+		return; /** Invalid GPIO pointer */
+	RCC_PERIPH_CLK_EN(GPIO_PORT_RCC_ID(port));
 	/*2.Set the pin mode */
 	GPIOx_Handle->pGPIOx->MODER &= ~(0x03 << (2 * gpio_pin_number)); /* Clear the bits */
 	GPIOx_Handle->pGPIOx->MODER |= (gpio_mode << (2 * gpio_pin_number)); /* Set the desire bits */
@@ -100,55 +101,126 @@ void gpio_pin_init(GPIOx_Handle_t *GPIOx_Handle) {
 
 }
 
+/*
+ * Spread a pin mask so bit n lands on the lowest bit of field n:
+ * 2-bit fields (MODER, OSPEEDR, PUPDR) or 4-bit fields (AFRL/AFRH, 8 pins).
+ * Multiplying the result by a field value replicates it into every
+ * selected field, multiplying by 0x3/0xF gives the field clear mask.
+ */
+static inline uint32_t gpio_spread_2bit(uint16_t pin_mask) {
+	uint32_t x = pin_mask;
+	x = (x | (x << 8)) & 0x00FF00FFU;
+	x = (x | (x << 4)) & 0x0F0F0F0FU;
+	x = (x | (x << 2)) & 0x33333333U;
+	x = (x | (x << 1)) & 0x55555555U;
+	return x;
+}
+
+static inline uint32_t gpio_spread_4bit(uint8_t pin_mask) {
+	uint32_t x = pin_mask;
+	x = (x | (x << 12)) & 0x000F000FU;
+	x = (x | (x << 6)) & 0x03030303U;
+	x = (x | (x << 3)) & 0x11111111U;
+	return x;
+}
+
+void gpio_port_init_mask(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask,
+		const GPIOx_Config_t *pConfig) {
+	uint8_t gpio_mode = pConfig->GPIO_MODE;
+	uint32_t lsb2 = gpio_spread_2bit(pin_mask);
+	uint32_t mask2 = lsb2 * 0x3U;
+
+	/*1. Enable the GPIO port clock */
+	uint32_t port = GPIO_PORT_INDEX(pGPIOx);
+	if (port >= GPIO_PORT_COUNT || pin_mask == 0)
+		return; /** Invalid GPIO pointer or nothing selected */
+	RCC_PERIPH_CLK_EN(GPIO_PORT_RCC_ID(port));
+
+	/*2. Output stage and AF first, MODER last, so the pins never drive
+	 *   with a stale type/speed or route the wrong alternate function */
+	if (gpio_mode == GPIO_MODE_OUTPUT || gpio_mode == GPIO_MODE_ALT_FUNC) {
+		pGPIOx->OSPEEDR = (pGPIOx->OSPEEDR & ~mask2) | (lsb2 * pConfig->GPIO_SPEED);
+		if (pConfig->GPIO_OP_TYPE) {
+			pGPIOx->OTYPER |= pin_mask;
+		} else {
+			pGPIOx->OTYPER &= ~(uint32_t) pin_mask;
+		}
+	}
+	if (gpio_mode != GPIO_MODE_ANALOG) {
+		pGPIOx->PUPDR = (pGPIOx->PUPDR & ~mask2) | (lsb2 * pConfig->GPIO_PU_PD);
+	}
+	if (gpio_mode == GPIO_MODE_ALT_FUNC) {
+		uint32_t lsb4_lo = gpio_spread_4bit((uint8_t) pin_mask);
+		uint32_t lsb4_hi = gpio_spread_4bit((uint8_t) (pin_mask >> 8));
+		if (lsb4_lo) {
+			pGPIOx->AFRL = (pGPIOx->AFRL & ~(lsb4_lo * 0xFU)) | (lsb4_lo * pConfig->GPIO_ALT_FUNC);
+		}
+		if (lsb4_hi) {
+			pGPIOx->AFRH = (pGPIOx->AFRH & ~(lsb4_hi * 0xFU)) | (lsb4_hi * pConfig->GPIO_ALT_FUNC);
+		}
+	}
+
+	/*3. Pin mode */
+	pGPIOx->MODER = (pGPIOx->MODER & ~mask2) | (lsb2 * gpio_mode);
+}
+
+void gpio_port_apply_image(const GPIOx_PortImage_t *pImage) {
+	GPIOx_RegDef_t *pGPIOx = pImage->pGPIOx;
+	uint32_t mask2 = gpio_spread_2bit(pImage->PinMask) * 0x3U;
+	uint32_t mask4_lo = gpio_spread_4bit((uint8_t) pImage->PinMask) * 0xFU;
+	uint32_t mask4_hi = gpio_spread_4bit((uint8_t) (pImage->PinMask >> 8)) * 0xFU;
+
+	/*1. Enable the GPIO port clock */
+	uint32_t port = GPIO_PORT_INDEX(pGPIOx);
+	if (port >= GPIO_PORT_COUNT || pImage->PinMask == 0)
+		return;
+	RCC_PERIPH_CLK_EN(GPIO_PORT_RCC_ID(port));
+
+	/*2. Same order as gpio_port_init_mask(): MODER last */
+	pGPIOx->OSPEEDR = (pGPIOx->OSPEEDR & ~mask2) | pImage->OSPEEDR;
+	pGPIOx->OTYPER = (pGPIOx->OTYPER & ~(uint32_t) pImage->PinMask) | pImage->OTYPER;
+	pGPIOx->PUPDR = (pGPIOx->PUPDR & ~mask2) | pImage->PUPDR;
+	if (mask4_lo) {
+		pGPIOx->AFRL = (pGPIOx->AFRL & ~mask4_lo) | pImage->AFRL;
+	}
+	if (mask4_hi) {
+		pGPIOx->AFRH = (pGPIOx->AFRH & ~mask4_hi) | pImage->AFRH;
+	}
+	pGPIOx->MODER = (pGPIOx->MODER & ~mask2) | pImage->MODER;
+}
+
+void gpio_port_apply_images(const GPIOx_PortImage_t *pImages, uint32_t count) {
+	for (uint32_t i = 0; i < count; i++) {
+		gpio_port_apply_image(&pImages[i]);
+	}
+}
+
 void gpio_port_deinit(GPIOx_RegDef_t *pGPIOx) {
-	if (pGPIOx == GPIOA) {
-//		RCC->AHB1RSTR |= (1 << 0); 	/* Assert the reset bit */
-//		RCC->AHB1RSTR &= ~(1 << 0);	/* De-assert the reset bit */
-		// Instead of this we will use macros.
-		GPIOA_RESET();
-	} else if (pGPIOx == GPIOB) {
-//		RCC->AHB1RSTR |= (1 << 1); 	/* Assert the reset bit */
-//		RCC->AHB1RSTR &= ~(1 << 1);	/* De-assert the reset bit */
-		// Instead of this we will use macros.
-		GPIOB_RESET();
-	} else if (pGPIOx == GPIOC) {
-//		RCC->AHB1RSTR |= (1 << 2); 	/* Assert the reset bit */
-//		RCC->AHB1RSTR &= ~(1 << 2);	/* De-assert the reset bit */
-		// Instead of this we will use macros.
-		GPIOC_RESET();
-	} else if (pGPIOx == GPIOD) {
-//		RCC->AHB1RSTR |= (1 << 3);	/* Assert the reset bit */
-//		RCC->AHB1RSTR &= ~(1 << 3);	/* De-assert the reset bit */
-		// Instead of this we will use macros.
-		GPIOD_RESET();
-	} else if (pGPIOx == GPIOE) {
-//		RCC->AHB1RSTR |= (1 << 4);	/* Assert the reset bit */
-//		RCC->AHB1RSTR &= ~(1 << 4);	/* De-assert the reset bit */
-		// Instead of this we will use macros.
-		GPIOE_RESET();
-	} else if (pGPIOx == GPIOF) {
-//		RCC->AHB1RSTR |= (1 << 5);	/* Assert the reset bit */
-//		RCC->AHB1RSTR &= ~(1 << 5);	/* De-assert the reset bit */
-		// Instead of this we will use macros.
-		GPIOF_RESET();
-	} else if (pGPIOx == GPIOG) {
-//		RCC->AHB1RSTR |= (1 << 6);	/* Assert the reset bit */
-//		RCC->AHB1RSTR &= ~(1 << 6);	/* De-assert the reset bit */
-		// Instead of this we will use macros.
-		GPIOG_RESET();
-	} else if (pGPIOx == GPIOH) {
-//		RCC->AHB1RSTR |= (1 << 7);	/* Assert the reset bit */
-//		RCC->AHB1RSTR &= ~(1 << 7);	/* De-assert the reset bit */
-		// Instead of this we will use macros.
-		GPIOH_RESET();
-	} else if (pGPIOx == GPIOI) {
-//		RCC->AHB1RSTR |= (1 << 8);	/* Assert the reset bit */
-//		RCC->AHB1RSTR &= ~(1 << 8);	/* De-assert the reset bit */
-		// Instead of this we will use macros.
-		GPIOI_RESET();
+	/* Assert and de-assert the AHB1RSTR bit of the port (bit = port index) */
+	uint32_t port = GPIO_PORT_INDEX(pGPIOx);
+	if (port < GPIO_PORT_COUNT) {
+		RCC_PERIPH_RESET(GPIO_PORT_RCC_ID(port));
 	}
 }
 
+uint8_t gpio_port_lock(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask) {
+	uint32_t key = (1U << GPIO_LCKR_LCKK_Pos) | pin_mask;
+
+	/* Key sequence: whole-word writes, LCKR[15:0] unchanged throughout */
+	pGPIOx->LCKR = key;
+	pGPIOx->LCKR = pin_mask;
+	pGPIOx->LCKR = key;
+	(void) pGPIOx->LCKR;
+
+	/* Second read returns the lock state */
+	return (pGPIOx->LCKR & (1U << GPIO_LCKR_LCKK_Pos)) ? SET : RESET;
+}
+
+uint16_t gpio_port_get_locked(GPIOx_RegDef_t *pGPIOx) {
+	uint32_t lckr = pGPIOx->LCKR;
+	return (lckr & (1U << GPIO_LCKR_LCKK_Pos)) ? (uint16_t) lckr : 0;
+}
+
 uint8_t gpio_read_pin(GPIOx_RegDef_t *pGPIOx, uint8_t pin) {
 	if (pin > 15)
 		return 0; /** @note Safety: Pin number cannot be more than 15 */
@@ -161,13 +233,30 @@ uint16_t gpio_read_port(GPIOx_RegDef_t *pGPIOx) {
 }
 
 void gpio_write_pin(GPIOx_RegDef_t *pGPIOx, uint8_t pin, uint8_t state) {
+	/* BSRR: bits [15:0] set, bits [31:16] reset. One store, no read of ODR,
+	 * so an ISR writing other pins of the port cannot be overwritten. */
 	if (state) {
-		pGPIOx->ODR |= ((1 << pin));
+		pGPIOx->BSRR = (1U << pin);
 	} else {
-		pGPIOx->ODR &= ~((1 << pin));
+		pGPIOx->BSRR = (1U << (pin + 16));
 	}
 }
 
+void gpio_set_pins(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask) {
+	pGPIOx->BSRR = pin_mask;
+}
+
+void gpio_clear_pins(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask) {
+	pGPIOx->BSRR = ((uint32_t) pin_mask << 16);
+}
+
+void gpio_write_pins_masked(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask,
+		uint16_t value) {
+	/* Set has priority over reset in BSRR, the two halves never overlap here */
+	pGPIOx->BSRR = (uint32_t) (pin_mask & value)
+			| ((uint32_t) (pin_mask & (uint16_t) ~value) << 16);
+}
+
 void gpio_write_port(GPIOx_RegDef_t *pGPIOx, uint16_t write_data) {
 	pGPIOx->ODR = write_data;
 }
@@ -175,20 +264,37 @@ void gpio_write_port(GPIOx_RegDef_t *pGPIOx, uint16_t write_data) {
 void gpio_toggle_pin(GPIOx_RegDef_t *pGPIOx, uint8_t pin) {
 	if (pin > 15)
 		return;
-	pGPIOx->ODR ^= (0x01 << pin);
+	gpio_toggle_pins(pGPIOx, (uint16_t) (1U << pin));
 }
 
-void gpio_irq_config(GPIOx_RegDef_t *pGPIOx, uint8_t pin, uint8_t trigger,
-		uint8_t irq_priority) {
-	/**
-	 * Sequence of steps in gpio_irq_config() API:
-	 * 1. Program SYSCFG
-	 * 2. Program EXTI
-	 * 3. Program Trigger mode
-	 * 4. Clear pending interrupt
-	 * 5. Unmask EXTI line
-	 * 6. Sets NVIC priority
-	 */
+void gpio_toggle_pins(GPIOx_RegDef_t *pGPIOx, uint16_t pin_mask) {
+	/* ODR is read once, the update is a single BSRR store: pins outside
+	 * pin_mask are never written back */
+	uint32_t odr = pGPIOx->ODR;
+	pGPIOx->BSRR = ((odr & pin_mask) << 16) | (~odr & pin_mask);
+}
+
+/*
+ * NVIC IRQ number serving an EXTI line.
+ */
+static uint8_t gpio_exti_irq(uint8_t pin) {
+	if (pin <= 4) {
+		/* EXTI0 → IRQ6, EXTI1 → IRQ7, ... EXTI4 → IRQ10 */
+		return (uint8_t) (IRQ_NUM_EXTI0 + pin);
+	} else if (pin <= 9) {
+		/* EXTI5–9 all map to EXTI9_5 shared IRQ */
+		return IRQ_NUM_EXTI9_5;
+	}
+	/* EXTI10–15 all map to EXTI15_10 shared IRQ */
+	return IRQ_NUM_EXTI15_10;
+}
+
+/*
+ * Route a port pin to its EXTI line and select the trigger edges.
+ * Shared by the interrupt (IMR) and event (EMR) configurations.
+ */
+static uint8_t gpio_exti_route(GPIOx_RegDef_t *pGPIOx, uint8_t pin,
+		uint8_t trigger) {
 	/** --------------------------------------------------------------------
 	 * 1. Enable SYSCFG Peripheral Clock
 	 *
@@ -204,10 +310,10 @@ void gpio_irq_config(GPIOx_RegDef_t *pGPIOx, uint8_t pin, uint8_t trigger,
 	 * 2. Determine which EXTICR register to use
 	 *
 	 * Each EXTICR register configures 4 pins:
-	 *   EXTICR1 → EXTI0..3
-	 *   EXTICR2 → EXTI4..7
-	 *   EXTICR3 → EXTI8..11
-	 *   EXTICR4 → EXTI12..15
+	 *   EXTICR1 (EXTICR[0]) → EXTI0..3
+	 *   EXTICR2 (EXTICR[1]) → EXTI4..7
+	 *   EXTICR3 (EXTICR[2]) → EXTI8..11
+	 *   EXTICR4 (EXTICR[3]) → EXTI12..15
 	 *
 	 * Index is pin / 4:
 	 *   pin 0–3   → 0
@@ -226,29 +332,11 @@ void gpio_irq_config(GPIOx_RegDef_t *pGPIOx, uint8_t pin, uint8_t trigger,
 	 *   0x2 = Port C
 	 *   ...
 	 *   0x8 = Port I
+	 * which is the port index, see @ref GPIO_PORT_INDEX_MACROS
 	 * -------------------------------------------------------------------- */
-	uint8_t gpio_port_map;
-
-	if (pGPIOx == GPIOA)
-		gpio_port_map = 0x00;
-	else if (pGPIOx == GPIOB)
-		gpio_port_map = 0x01;
-	else if (pGPIOx == GPIOC)
-		gpio_port_map = 0x02;
-	else if (pGPIOx == GPIOD)
-		gpio_port_map = 0x03;
-	else if (pGPIOx == GPIOE)
-		gpio_port_map = 0x04;
-	else if (pGPIOx == GPIOF)
-		gpio_port_map = 0x05;
-	else if (pGPIOx == GPIOG)
-		gpio_port_map = 0x06;
-	else if (pGPIOx == GPIOH)
-		gpio_port_map = 0x07;
-	else if (pGPIOx == GPIOI)
-		gpio_port_map = 0x08;
-	else
-		return; /** Invalid GPIO pointer */
+	uint32_t gpio_port_map = GPIO_PORT_INDEX(pGPIOx);
+	if (gpio_port_map >= GPIO_PORT_COUNT)
+		return 0; /** Invalid GPIO pointer */
 
 	/** --------------------------------------------------------------------
 	 * 4. Configure the correct SYSCFG_EXTICR register
@@ -262,25 +350,10 @@ void gpio_irq_config(GPIOx_RegDef_t *pGPIOx, uint8_t pin, uint8_t trigger,
 	 * -------------------------------------------------------------------- */
 	uint8_t shift_amount = 4 * (pin % 4);
 
-	if (sys_cfg_reg_number == 0) {
-		/** Configure EXTI0–3 */
-		pSYSCFG->EXTICR1 &= ~(0xF << shift_amount);
-		pSYSCFG->EXTICR1 |= (gpio_port_map << shift_amount);
-	} else if (sys_cfg_reg_number == 1) {
-		/** Configure EXTI4–7 */
-		pSYSCFG->EXTICR2 &= ~(0xF << shift_amount);
-		pSYSCFG->EXTICR2 |= (gpio_port_map << shift_amount);
-	} else if (sys_cfg_reg_number == 2) {
-		/** Configure EXTI8–11 */
-		pSYSCFG->EXTICR3 &= ~(0xF << shift_amount);
-		pSYSCFG->EXTICR3 |= (gpio_port_map << shift_amount);
-	} else if (sys_cfg_reg_number == 3) {
-		/** Configure EXTI12–15 */
-		pSYSCFG->EXTICR4 &= ~(0xF << shift_amount);
-		pSYSCFG->EXTICR4 |= (gpio_port_map << shift_amount);
-	}
+	pSYSCFG->EXTICR[sys_cfg_reg_number] &= ~(0xF << shift_amount);
+	pSYSCFG->EXTICR[sys_cfg_reg_number] |= (gpio_port_map << shift_amount);
 
-	/** 3. Setting rising/falling trigger or both */
+	/** 5. Setting rising/falling trigger or both */
 	EXTI_RegDef_t *pEXTI = EXTI;
 	pEXTI->RTSR &= ~(1 << pin);
 	pEXTI->FTSR &= ~(1 << pin);
@@ -292,53 +365,88 @@ void gpio_irq_config(GPIOx_RegDef_t *pGPIOx, uint8_t pin, uint8_t trigger,
 		pEXTI->RTSR |= (1 << pin);
 		pEXTI->FTSR |= (1 << pin);
 	}
+	return 1;
+}
+
+void gpio_irq_config(GPIOx_RegDef_t *pGPIOx, uint8_t pin, uint8_t trigger,
+		uint8_t irq_priority) {
+	/**
+	 * Sequence of steps in gpio_irq_config() API:
+	 * 1. Program SYSCFG
+	 * 2. Program EXTI
+	 * 3. Program Trigger mode
+	 * 4. Clear pending interrupt
+	 * 5. Unmask EXTI line
+	 * 6. Sets NVIC priority
+	 */
+	/** 1..3 SYSCFG routing and trigger edges */
+	if (!gpio_exti_route(pGPIOx, pin, trigger))
+		return;
+	EXTI_RegDef_t *pEXTI = EXTI;
 
-	/** 4 Clearing the pending interrupt. A interrupt is clearing by writing 1 to EXTI_PR Register */
-	pEXTI->PR |= (1 << pin);
+	/** 4 Clearing the pending interrupt. A interrupt is clearing by writing 1 to EXTI_PR Register.
+	 *  Plain store: a read-modify-write would clear every other pending line too */
+	pEXTI->PR = (1U << pin);
 
 	/** 5. After Clearing the pending bit. Now unmask the interrupt.*/
-	pEXTI->IMR |= (1 << pin);
+	PERIPH_BIT_SET(pEXTI->IMR, pin);
 
 	/** 6. Finally, configure the NVIC interrupt priority */
+	nvic_set_priority(gpio_exti_irq(pin), irq_priority);
+}
 
-	uint8_t irq;
+void gpio_irq_clear(uint8_t pin) {
+	EXTI_RegDef_t *pEXTI = EXTI;
+	pEXTI->PR = (1U << pin); /* write-1-to-clear, no read-modify-write */
+}
 
-	/* Step 1: Identify which IRQ vector corresponds to the EXTI line */
-	if (pin <= 4) {
-		/* EXTI0 → IRQ6, EXTI1 → IRQ7, ... EXTI4 → IRQ10 */
-		irq = IRQ_NUM_EXTI0 + pin;
-	} else if (pin <= 9) {
-		/* EXTI5–9 all map to EXTI9_5 shared IRQ */
-		irq = IRQ_NUM_EXTI9_5;
+void gpio_event_config(GPIOx_RegDef_t *pGPIOx, uint8_t pin,
+		uint8_t trigger) {
+	/* Same routing as an interrupt, but only EMR: the edge pulses the core's
+	 * event input, no PR flag, no NVIC, no handler entry/exit */
+	if (!gpio_exti_route(pGPIOx, pin, trigger))
+		return;
+	PERIPH_BIT_SET(EXTI->EMR, pin);
+}
+
+void gpio_event_control(uint8_t pin, uint8_t en_di) {
+	if (en_di == ENABLE) {
+		PERIPH_BIT_SET(EXTI->EMR, pin);
 	} else {
-		/* EXTI10–15 all map to EXTI15_10 shared IRQ */
-		irq = IRQ_NUM_EXTI15_10;
+		PERIPH_BIT_CLR(EXTI->EMR, pin);
 	}
+}
 
-	/* Step 2: Compute the NVIC IPR register and byte offset */
-	NVIC_RegDef_t *pNVIC = NVIC;
-	uint8_t ipr_index = irq / 4;          // Each IPR holds 4 priority fields
-	uint8_t ipr_offset = (irq % 4) * 8;   // Select correct byte
-	ipr_offset += 4;                    // Priority uses only upper 4 bits [7:4]
-
-	/*
-	 * Step 3: Clear the old priority
-	 * We clear a full byte (even though only 4 bits are used),
-	 * because NVIC ignores the lower 4 bits anyway.
-	 */
-	pNVIC->IPR[ipr_index] &= ~(0xFF << ipr_offset);
-
-	/*
-	 * Step 4: Write new priority
-	 * irq_priority is masked to 4 bits (0–15),
-	 * then shifted into bits [7:4] of the correct byte.
-	 */
-	pNVIC->IPR[ipr_index] |= ((irq_priority & 0x0F) << ipr_offset);
+uint8_t gpio_wait_for_edge(GPIOx_RegDef_t *pGPIOx, uint8_t pin, uint8_t level) {
+	EXTI_RegDef_t *pEXTI = EXTI;
+	uint32_t bit = 1U << pin;
+	if (pin > 15)
+		return GPIO_WAKE_INVALID;
+
+	/* The event register is sticky: an edge between the check and WFE makes
+	 * WFE return at once, so no wake-up is lost. Other events (SEV, other
+	 * lines) just cause one more check. */
+	while (gpio_read_pin(pGPIOx, pin) != level) {
+		if ((pEXTI->SWIER & ~pEXTI->IMR) & bit) {
+			pEXTI->PR = bit; /* Software trigger consumed, clears SWIER */
+			return GPIO_WAKE_SOFTWARE;
+		}
+		__asm volatile ("wfe" ::: "memory");
+	}
+	return GPIO_WAKE_LEVEL;
 }
 
-void gpio_irq_clear(uint8_t pin) {
+void gpio_exti_software_trigger(uint8_t line) {
 	EXTI_RegDef_t *pEXTI = EXTI;
-	pEXTI->PR |= (1 << pin);
+	uint32_t bit = 1U << line;
+	if (line > 15)
+		return;
+	/* Only a 0->1 write raises the line. In event-only mode PR never gets set,
+	 * so an old request is still in SWIER: clear it through PR first */
+	if ((pEXTI->SWIER & ~pEXTI->IMR) & bit) {
+		pEXTI->PR = bit;
+	}
+	pEXTI->SWIER = bit;
 }
 
 void gpio_irq_control(uint8_t pin, uint8_t en_di) {
@@ -361,49 +469,150 @@ void gpio_irq_control(uint8_t pin, uint8_t en_di) {
 	 *       No need to write to NVIC->ICPR for EXTI lines.
 	 */
 
-	NVIC_RegDef_t *pNVIC = NVIC;
 	EXTI_RegDef_t *pEXTI = EXTI;
 
 	if (en_di == ENABLE) {
-		// 1. Unmask the EXTI line in EXTI_IMR
-		pEXTI->IMR |= (1 << pin);
+		// 1. Unmask the EXTI line in EXTI_IMR (bit-band store, no read-modify-write)
+		PERIPH_BIT_SET(pEXTI->IMR, pin);
 		// 2. Enable the corresponding NVIC interrupt via NVIC_ISER
-		uint8_t irq;
-		if (pin <= 4) {
-			/* EXTI0 → IRQ6, EXTI1 → IRQ7, ... EXTI4 → IRQ10 */
-			irq = IRQ_NUM_EXTI0 + pin;
-			pNVIC->ISER[0] |= (1 << irq);
-		} else if (pin <= 9) {
-			/* EXTI5–9 all map to EXTI9_5 shared IRQ */
-			irq = IRQ_NUM_EXTI9_5;
-			pNVIC->ISER[0] |= (1 << irq);
-		} else {
-			/* EXTI10–15 all map to EXTI15_10 shared IRQ */
-			irq = IRQ_NUM_EXTI15_10;
-			pNVIC->ISER[1] |= (1 << (irq % 32));
-		}
+		nvic_enable_irq(gpio_exti_irq(pin));
 		// 3. Clear the Pending interrupt.
 		gpio_irq_clear(pin);
 	} else {                      //Disable interrupt
-		// 1. Mask the EXTI line in EXTI_IMR
-		pEXTI->IMR &= ~(1 << pin);
-		// 2. Disable the corresponding NVIC interrupt via NVIC_ISER
-		uint8_t irq;
-		if (pin <= 4) {
-			/* EXTI0 → IRQ6, EXTI1 → IRQ7, ... EXTI4 → IRQ10 */
-			irq = IRQ_NUM_EXTI0 + pin;
-			pNVIC->ICER[0] |= (1 << irq);
-		} else if (pin <= 9) {
-			/* EXTI5–9 all map to EXTI9_5 shared IRQ */
-			irq = IRQ_NUM_EXTI9_5;
-			pNVIC->ICER[0] |= (1 << irq);
-		} else {
-			/* EXTI10–15 all map to EXTI15_10 shared IRQ */
-			irq = IRQ_NUM_EXTI15_10;
-			pNVIC->ICER[1] |= (1 << (irq % 32));
-		}
+		// 1. Mask the EXTI line in EXTI_IMR (bit-band store, no read-modify-write)
+		PERIPH_BIT_CLR(pEXTI->IMR, pin);
+		// 2. Disable the corresponding NVIC interrupt via NVIC_ICER
+		nvic_disable_irq(gpio_exti_irq(pin));
 		// 3. Clear the Pending interrupt.
 		gpio_irq_clear(pin);
 	}
 }
 
+/*
+ * EXTI line callbacks, indexed by line.
+ */
+static struct {
+	GPIO_ExtiCallback_t callback;
+	void *pContext;
+} gpio_exti_table[16];
+
+void gpio_exti_register(uint8_t line, GPIO_ExtiCallback_t callback,
+		void *pContext) {
+	if (line > 15)
+		return;
+	gpio_exti_table[line].pContext = pContext;
+	gpio_exti_table[line].callback = callback;
+}
+
+#if (GPIO_EXTI_CAPTURE_LEN & (GPIO_EXTI_CAPTURE_LEN - 1)) != 0
+#error "GPIO_EXTI_CAPTURE_LEN must be a power of two"
+#endif
+
+/*
+ * Edge capture ring: the dispatcher writes head, the drain writes tail.
+ * Free-running indices, head - tail is the fill level.
+ */
+static GPIO_ExtiCapture_t gpio_capture_ring[GPIO_EXTI_CAPTURE_LEN];
+static volatile uint32_t gpio_capture_head;
+static volatile uint32_t gpio_capture_tail;
+static volatile uint32_t gpio_capture_overflow;
+static volatile uint32_t gpio_capture_mask;
+
+static void gpio_exti_capture_push(uint8_t line, uint32_t timestamp) {
+	uint32_t head = gpio_capture_head;
+	if (head - gpio_capture_tail == GPIO_EXTI_CAPTURE_LEN) {
+		gpio_capture_overflow++;
+		return;
+	}
+	/* Source port of the line, as selected in SYSCFG_EXTICR */
+	uint32_t port = (SYSCFG->EXTICR[line >> 2] >> (4U * (line & 3U))) & 0xFU;
+	GPIO_ExtiCapture_t *pRec = &gpio_capture_ring[head & (GPIO_EXTI_CAPTURE_LEN - 1)];
+	pRec->Timestamp = timestamp;
+	pRec->Line = line;
+	pRec->Level = (uint8_t) ((GPIO_PORT_FROM_INDEX(port)->IDR >> line) & 0x1);
+	/* Record complete before it is published */
+	COMPILER_BARRIER();
+	gpio_capture_head = head + 1;
+}
+
+ISR_RAMFUNC void gpio_exti_dispatch(uint32_t line_mask) {
+	/* Stamp first, the closest this vector gets to the edge */
+	uint32_t now = DWT->CYCCNT;
+	EXTI_RegDef_t *pEXTI = EXTI;
+	uint32_t pending = pEXTI->PR & pEXTI->IMR & line_mask;
+	uint32_t capture = pending & gpio_capture_mask;
+
+	/* One write clears everything served below; an edge arriving while the
+	 * callbacks run sets PR again and re-enters the vector */
+	pEXTI->PR = pending;
+
+	while (pending) {
+		uint8_t line = (uint8_t) (31U - __builtin_clz(pending));
+		pending &= ~(1U << line);
+		if (capture & (1U << line)) {
+			gpio_exti_capture_push(line, now);
+		}
+		if (gpio_exti_table[line].callback) {
+			gpio_exti_table[line].callback(line, gpio_exti_table[line].pContext);
+		}
+	}
+}
+
+void gpio_exti_capture_start(uint32_t line_mask) {
+	/* Cycle counter: trace enable, then counter enable */
+	COREDEBUG->DEMCR |= (1U << COREDEBUG_DEMCR_TRCENA_Pos);
+	DWT->CTRL |= (1U << DWT_CTRL_CYCCNTENA_Pos);
+	gpio_capture_mask |= (line_mask & GPIO_EXTI_LINES_ALL);
+}
+
+void gpio_exti_capture_stop(uint32_t line_mask) {
+	gpio_capture_mask &= ~line_mask;
+}
+
+uint32_t gpio_exti_capture_drain(GPIO_ExtiCapture_t *pOut, uint32_t max) {
+	uint32_t tail = gpio_capture_tail;
+	uint32_t count = gpio_capture_head - tail;
+	if (count > max)
+		count = max;
+	for (uint32_t i = 0; i < count; i++) {
+		pOut[i] = gpio_capture_ring[(tail + i) & (GPIO_EXTI_CAPTURE_LEN - 1)];
+	}
+	/* Slots copied before they are handed back to the dispatcher */
+	COMPILER_BARRIER();
+	gpio_capture_tail = tail + count;
+	return count;
+}
+
+uint32_t gpio_exti_capture_get_overflow_count(void) {
+	return gpio_capture_overflow;
+}
+
+#if GPIO_EXTI_DISPATCH_EN
+void EXTI0_IRQHandler(void) {
+	gpio_exti_dispatch(1U << 0);
+}
+
+void EXTI1_IRQHandler(void) {
+	gpio_exti_dispatch(1U << 1);
+}
+
+void EXTI2_IRQHandler(void) {
+	gpio_exti_dispatch(1U << 2);
+}
+
+void EXTI3_IRQHandler(void) {
+	gpio_exti_dispatch(1U << 3);
+}
+
+void EXTI4_IRQHandler(void) {
+	gpio_exti_dispatch(1U << 4);
+}
+
+void EXTI9_5_IRQHandler(void) {
+	gpio_exti_dispatch(GPIO_EXTI_LINES_9_5);
+}
+
+void EXTI15_10_IRQHandler(void) {
+	gpio_exti_dispatch(GPIO_EXTI_LINES_15_10);
+}
+#endif /* GPIO_EXTI_DISPATCH_EN */
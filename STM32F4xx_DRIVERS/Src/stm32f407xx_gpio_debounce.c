@@ -0,0 +1,146 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_gpio_debounce.c
+ * @author  Yuvraj Singh Rathore
+ * @version 1.0
+ * @date    10-Dec-2025
+ * @brief   Non-blocking button/edge debouncing source file for STM32F407xx MCU.
+ *
+ * @details
+ * Replaces busy-wait debouncing inside EXTI handlers:
+ *
+ *  - EXTI callback: mask the line, mark the button active, return
+ *  - Tick: sample active buttons, accept a level after it stayed stable
+ *    for GPIO_DEBOUNCE_SETTLE_TICKS, report long presses
+ *  - Events go to a single-producer/single-consumer queue read from thread mode
+ *
+ * @section GPIO_DEBOUNCE_API_Summary Debounce API Summary
+ *
+ * - gpio_debounce_init()      : Attach a button to its EXTI line
+ * - gpio_debounce_tick()      : Periodic sampling
+ * - gpio_debounce_get_event() : Read the next event
+ * - gpio_debounce_get_overflow_count() : Events lost to a full queue
+ *
+ * @see stm32f407xx_gpio_debounce.h
+ ******************************************************************************
+ */
+
+#include "stm32f407xx_gpio_debounce.h"
+
+#if (GPIO_DEBOUNCE_QUEUE_LEN & (GPIO_DEBOUNCE_QUEUE_LEN - 1)) != 0
+#error "GPIO_DEBOUNCE_QUEUE_LEN must be a power of two"
+#endif
+
+/** Buttons by EXTI line, only one input can own a line */
+static GPIO_DebounceButton_t *debounce_buttons[16];
+
+/** Written by the tick only (head) and by the reader only (tail) */
+static GPIO_DebounceEvent_t debounce_queue[GPIO_DEBOUNCE_QUEUE_LEN];
+static volatile uint32_t debounce_head;
+static volatile uint32_t debounce_tail;
+static volatile uint32_t debounce_overflow;
+
+static void debounce_push(uint8_t pin, uint8_t event) {
+	uint32_t head = debounce_head;
+	if (head - debounce_tail == GPIO_DEBOUNCE_QUEUE_LEN) {
+		debounce_overflow++;
+		return;
+	}
+	debounce_queue[head & (GPIO_DEBOUNCE_QUEUE_LEN - 1)].Pin = pin;
+	debounce_queue[head & (GPIO_DEBOUNCE_QUEUE_LEN - 1)].Event = event;
+	COMPILER_BARRIER(); /* Entry complete before it is published */
+	debounce_head = head + 1;
+}
+
+static inline uint8_t debounce_is_pressed(const GPIO_DebounceButton_t *pButton) {
+	return (gpio_read_pin(pButton->pGPIOx, pButton->Pin) == pButton->ActiveLevel) ? 1 : 0;
+}
+
+/*
+ * EXTI callback: the whole ISR cost of a bounce is this mask + flag.
+ */
+static void debounce_edge(uint8_t line, void *pContext) {
+	GPIO_DebounceButton_t *pButton = (GPIO_DebounceButton_t*) pContext;
+	PERIPH_BIT_CLR(EXTI->IMR, line);
+	pButton->StableTicks = 0;
+	pButton->Active = 1;
+}
+
+void gpio_debounce_init(GPIO_DebounceButton_t *pButton) {
+	uint8_t pin = pButton->Pin;
+	if (pin > 15)
+		return;
+
+	pButton->Active = 0;
+	pButton->Pressed = debounce_is_pressed(pButton);
+	pButton->LongSent = 0;
+	pButton->StableTicks = 0;
+	pButton->HeldTicks = 0;
+	debounce_buttons[pin] = pButton;
+
+	/** Both edges: a press already down at init is still released cleanly */
+	gpio_exti_register(pin, debounce_edge, pButton);
+	gpio_irq_config(pButton->pGPIOx, pin, INTERRUPT_TRIGGER_TYPE_BOTH, pButton->IrqPriority);
+	gpio_irq_control(pin, ENABLE);
+}
+
+void gpio_debounce_tick(void) {
+	for (uint8_t pin = 0; pin < 16; pin++) {
+		GPIO_DebounceButton_t *pButton = debounce_buttons[pin];
+		if (pButton == NULL || !pButton->Active)
+			continue;
+
+		/*1. Accept a new level only after it held for the settle time */
+		if (debounce_is_pressed(pButton) == pButton->Pressed) {
+			pButton->StableTicks = 0;
+		} else if (++pButton->StableTicks >= GPIO_DEBOUNCE_SETTLE_TICKS) {
+			pButton->StableTicks = 0;
+			pButton->Pressed ^= 1;
+			if (pButton->Pressed) {
+				pButton->HeldTicks = 0;
+				pButton->LongSent = 0;
+				debounce_push(pin, GPIO_DEBOUNCE_EVENT_PRESS);
+			} else {
+				debounce_push(pin, GPIO_DEBOUNCE_EVENT_RELEASE);
+			}
+		}
+
+		/*2. Long press while held */
+		if (pButton->Pressed) {
+			if (!pButton->LongSent && ++pButton->HeldTicks >= GPIO_DEBOUNCE_LONG_TICKS) {
+				pButton->LongSent = 1;
+				debounce_push(pin, GPIO_DEBOUNCE_EVENT_LONG_PRESS);
+			}
+			continue;
+		}
+
+		/*3. Released and settled: hand the line back to EXTI. PR is gated by
+		 *   IMR, so an edge while masked is lost: sample once more after the
+		 *   unmask and stay active if the pin has already moved. */
+		if (pButton->StableTicks == 0) {
+			uint32_t primask = nvic_irq_save();
+			EXTI->PR = (1U << pin);
+			PERIPH_BIT_SET(EXTI->IMR, pin);
+			if (debounce_is_pressed(pButton)) {
+				PERIPH_BIT_CLR(EXTI->IMR, pin);
+			} else {
+				pButton->Active = 0;
+			}
+			nvic_irq_restore(primask);
+		}
+	}
+}
+
+uint8_t gpio_debounce_get_event(GPIO_DebounceEvent_t *pEvent) {
+	uint32_t tail = debounce_tail;
+	if (tail == debounce_head)
+		return 0;
+	*pEvent = debounce_queue[tail & (GPIO_DEBOUNCE_QUEUE_LEN - 1)];
+	COMPILER_BARRIER(); /* Entry copied before the slot is handed back */
+	debounce_tail = tail + 1;
+	return 1;
+}
+
+uint32_t gpio_debounce_get_overflow_count(void) {
+	return debounce_overflow;
+}
@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_nvic.c
+ * @author  Yuvraj Singh Rathore
+ * @version 1.0
+ * @date    12-Dec-2025
+ * @brief   NVIC driver source file for STM32F407xx MCU.
+ *
+ * @details
+ * Generic interrupt controller access for every IRQ number:
+ *
+ *  - ISER/ICER/ISPR/ICPR are write-1 registers, one plain store per call
+ *  - IPR is byte addressable, one byte store per priority
+ *  - AIRCR grouping with the VECTKEY write sequence
+ *  - BASEPRI critical sections that leave higher priorities running
+ *  - PRIMASK sections for data shared with handlers of any priority
+ *
+ * @section NVIC_API_Summary NVIC Driver API Summary
+ *
+ * - nvic_enable_irq() / nvic_disable_irq() / nvic_is_enabled()
+ * - nvic_set_pending() / nvic_clear_pending() / nvic_is_pending()
+ * - nvic_is_active()
+ * - nvic_set_priority_grouping() / nvic_get_priority_grouping()
+ * - nvic_encode_priority() / nvic_set_priority() / nvic_get_priority()
+ * - nvic_critical_enter() / nvic_critical_exit()
+ * - nvic_irq_save() / nvic_irq_restore()
+ * - nvic_get_vector()
+ * - nvic_vector_table_relocate() / nvic_set_vector() (NVIC_VECTOR_TABLE_RAM_EN)
+ *
+ * @see stm32f407xx_nvic.h
+ ******************************************************************************
+ */
+
+#include "stm32f407xx_nvic.h"
+
+#define NVIC_WORD(IRQ)  ((IRQ) >> 5)
+#define NVIC_BIT(IRQ)   (1UL << ((IRQ) & 0x1FU))
+
+void nvic_enable_irq(uint8_t IRQNumber) {
+	NVIC->ISER[NVIC_WORD(IRQNumber)] = NVIC_BIT(IRQNumber);
+}
+
+void nvic_disable_irq(uint8_t IRQNumber) {
+	NVIC->ICER[NVIC_WORD(IRQNumber)] = NVIC_BIT(IRQNumber);
+	__asm volatile ("dsb\n\tisb" ::: "memory");
+}
+
+uint8_t nvic_is_enabled(uint8_t IRQNumber) {
+	return (NVIC->ISER[NVIC_WORD(IRQNumber)] & NVIC_BIT(IRQNumber)) ? 1 : 0;
+}
+
+void nvic_set_pending(uint8_t IRQNumber) {
+	NVIC->ISPR[NVIC_WORD(IRQNumber)] = NVIC_BIT(IRQNumber);
+}
+
+void nvic_clear_pending(uint8_t IRQNumber) {
+	NVIC->ICPR[NVIC_WORD(IRQNumber)] = NVIC_BIT(IRQNumber);
+}
+
+uint8_t nvic_is_pending(uint8_t IRQNumber) {
+	return (NVIC->ISPR[NVIC_WORD(IRQNumber)] & NVIC_BIT(IRQNumber)) ? 1 : 0;
+}
+
+uint8_t nvic_is_active(uint8_t IRQNumber) {
+	return (NVIC->IABR[NVIC_WORD(IRQNumber)] & NVIC_BIT(IRQNumber)) ? 1 : 0;
+}
+
+void nvic_set_priority_grouping(uint8_t PriorityGroup) {
+	/* AIRCR ignores writes without the key; keep the other fields as they are */
+	uint32_t aircr = SCB->AIRCR;
+	aircr &= ~((0xFFFFUL << SCB_AIRCR_VECTKEY_Pos) | (0x7UL << SCB_AIRCR_PRIGROUP_Pos));
+	aircr |= (SCB_AIRCR_VECTKEY << SCB_AIRCR_VECTKEY_Pos)
+			| ((uint32_t) (PriorityGroup & 0x7U) << SCB_AIRCR_PRIGROUP_Pos);
+	SCB->AIRCR = aircr;
+}
+
+uint8_t nvic_get_priority_grouping(void) {
+	return (uint8_t) ((SCB->AIRCR >> SCB_AIRCR_PRIGROUP_Pos) & 0x7U);
+}
+
+uint8_t nvic_encode_priority(uint8_t PreemptPriority, uint8_t SubPriority) {
+	uint32_t group = nvic_get_priority_grouping();
+	/* PRIGROUP n: bits [7:n+1] preempt, [n:0] sub; with 4 bits at [7:4],
+	 * sub-priority bits = n - 3 (clamped 0..4) */
+	uint32_t sub_bits = (group > 3U) ? (group - 3U) : 0U;
+	uint32_t preempt_bits = NVIC_PRIO_BITS - sub_bits;
+
+	return (uint8_t) (((PreemptPriority & ((1UL << preempt_bits) - 1U)) << sub_bits)
+			| (SubPriority & ((1UL << sub_bits) - 1U)));
+}
+
+void nvic_set_priority(uint8_t IRQNumber, uint8_t Priority) {
+	/* Each IRQ owns one byte in the IPR array, only bits [7:4] are implemented */
+	volatile uint8_t *pIPR = (volatile uint8_t*) NVIC->IPR;
+	pIPR[IRQNumber] = (uint8_t) ((Priority & 0x0FU) << (8U - NVIC_PRIO_BITS));
+}
+
+uint8_t nvic_get_priority(uint8_t IRQNumber) {
+	volatile uint8_t *pIPR = (volatile uint8_t*) NVIC->IPR;
+	return (uint8_t) (pIPR[IRQNumber] >> (8U - NVIC_PRIO_BITS));
+}
+
+uint32_t nvic_critical_enter(uint8_t Priority) {
+	uint32_t prev;
+	uint32_t basepri = (uint32_t) (Priority & 0x0FU) << (8U - NVIC_PRIO_BITS);
+	__asm volatile ("MRS %0, BASEPRI" : "=r" (prev) :: "memory");
+	/* BASEPRI_MAX only ever raises the masking level */
+	__asm volatile ("MSR BASEPRI_MAX, %0\n\tisb" :: "r" (basepri) : "memory");
+	return prev;
+}
+
+void nvic_critical_exit(uint32_t PrevBasepri) {
+	__asm volatile ("MSR BASEPRI, %0\n\tisb" :: "r" (PrevBasepri) : "memory");
+}
+
+uint32_t nvic_irq_save(void) {
+	uint32_t primask;
+	__asm volatile ("MRS %0, PRIMASK\n\tCPSID i" : "=r" (primask) :: "memory");
+	return primask;
+}
+
+void nvic_irq_restore(uint32_t PrevPrimask) {
+	__asm volatile ("MSR PRIMASK, %0" :: "r" (PrevPrimask) : "memory");
+}
+
+NVIC_Handler_t nvic_get_vector(uint8_t IRQNumber) {
+	if (IRQNumber > IRQ_NUM_FPU) {
+		return NULL;
+	}
+	const uint32_t *pTable = (const uint32_t*) (uintptr_t) SCB->VTOR;
+	return (NVIC_Handler_t) (uintptr_t) pTable[16U + IRQNumber];
+}
+
+#if NVIC_VECTOR_TABLE_RAM_EN
+static uint32_t nvic_vector_table[NVIC_VECTOR_COUNT]
+		__attribute__((aligned(NVIC_VECTOR_TABLE_ALIGN)));
+
+void nvic_vector_table_relocate(void) {
+	/* VTOR reads 0 after reset, flash is aliased there */
+	const uint32_t *pFlash = (const uint32_t*) (uintptr_t) SCB->VTOR;
+
+	if (pFlash == nvic_vector_table) {
+		return;
+	}
+	uint32_t primask = nvic_irq_save();
+	for (uint32_t i = 0; i < NVIC_VECTOR_COUNT; i++) {
+		nvic_vector_table[i] = pFlash[i];
+	}
+	/* Table writes complete before any exception can use the new base */
+	__asm volatile ("dsb" ::: "memory");
+	SCB->VTOR = (uint32_t) (uintptr_t) nvic_vector_table;
+	__asm volatile ("dsb\n\tisb" ::: "memory");
+	nvic_irq_restore(primask);
+}
+
+uint8_t nvic_set_vector(uint8_t IRQNumber, NVIC_Handler_t pfHandler) {
+	if (IRQNumber > IRQ_NUM_FPU || SCB->VTOR != (uint32_t) (uintptr_t) nvic_vector_table) {
+		return RESET;
+	}
+	nvic_vector_table[16U + IRQNumber] = (uint32_t) (uintptr_t) pfHandler;
+	__asm volatile ("dsb" ::: "memory");
+	return SET;
+}
+#endif
@@ -0,0 +1,273 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_rcc.c
+ * @author  Yuvraj Singh Rathore
+ * @version 1.0
+ * @date    15-Dec-2025
+ * @brief   RCC clock tree driver source file for STM32F407xx MCU.
+ *
+ * @details
+ * Brings the device from the 16 MHz HSI reset clock up to HSE + PLL
+ * (168 MHz max) and back, in an order that never runs the core or a bus
+ * above its limit for the current flash latency:
+ *
+ *  - Flash wait states raised before and lowered after the switch
+ *  - PLL reprogrammed only while SYSCLK runs from HSI
+ *  - APB prescalers parked at /16 while HCLK changes
+ *
+ * @section RCC_API_Summary RCC Driver API Summary
+ *
+ * - rcc_clock_config()  : Switch to a new clock configuration
+ * - rcc_set_preset()    : Switch to a RCC_PRESET_* configuration
+ * - rcc_clock_hook_register()/unregister() : Clock change notification
+ * - rcc_get_sysclk()    : SYSCLK in Hz
+ * - rcc_get_hclk()      : AHB clock in Hz
+ * - rcc_get_pclk1()     : APB1 clock in Hz
+ * - rcc_get_pclk2()     : APB2 clock in Hz
+ * - rcc_get_bus_clock() : Bus clock of a peripheral
+ *
+ * @see stm32f407xx_rcc.h
+ ******************************************************************************
+ */
+
+#include "stm32f407xx_rcc.h"
+
+/** Right shift applied to SYSCLK for every HPRE / PPRE field value */
+static const uint8_t rcc_ahb_shift[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 6, 7, 8, 9 };
+static const uint8_t rcc_apb_shift[8] = { 0, 0, 0, 0, 1, 2, 3, 4 };
+
+static uint8_t rcc_wait(uint32_t Mask, uint32_t Value) {
+	for (uint32_t i = 0; i < RCC_READY_TIMEOUT; i++) {
+		if ((RCC->CR & Mask) == Value) {
+			return SET;
+		}
+	}
+	return RESET;
+}
+
+static void rcc_switch_sysclk(uint32_t Source) {
+	RCC->CFGR = (RCC->CFGR & ~(0x3UL << RCC_CFGR_SW_Pos)) | (Source << RCC_CFGR_SW_Pos);
+	while (((RCC->CFGR >> RCC_CFGR_SWS_Pos) & 0x3UL) != Source);
+}
+
+/*
+ * SYSCLK a configuration produces, 0 if the PLL factors are out of range.
+ */
+static uint32_t rcc_config_sysclk(const RCC_Config_t *pConfig) {
+	if (pConfig->RCC_SYSCLK_SOURCE == RCC_SYSCLK_SOURCE_HSI) {
+		return RCC_HSI_VALUE;
+	} else if (pConfig->RCC_SYSCLK_SOURCE == RCC_SYSCLK_SOURCE_HSE) {
+		return RCC_HSE_VALUE;
+	}
+	uint32_t src = (pConfig->RCC_PLL_SOURCE == RCC_PLL_SOURCE_HSE) ? RCC_HSE_VALUE : RCC_HSI_VALUE;
+	if (pConfig->RCC_PLL_M < 2 || pConfig->RCC_PLL_M > 63 || pConfig->RCC_PLL_N < 50
+			|| pConfig->RCC_PLL_N > 432 || pConfig->RCC_PLL_Q < 2 || pConfig->RCC_PLL_Q > 15
+			|| pConfig->RCC_PLL_P < 2 || pConfig->RCC_PLL_P > 8 || (pConfig->RCC_PLL_P & 1U)) {
+		return 0;
+	}
+	uint32_t vco_in = src / pConfig->RCC_PLL_M;
+	uint32_t vco = vco_in * pConfig->RCC_PLL_N;
+	if (vco_in < 1000000UL || vco_in > 2000000UL || vco < 100000000UL || vco > 432000000UL) {
+		return 0;
+	}
+	return vco / pConfig->RCC_PLL_P;
+}
+
+/*
+ * Steps 2..6 of rcc_clock_config(), on an already checked configuration.
+ */
+static uint8_t rcc_clock_switch(const RCC_Config_t *pConfig, uint32_t sysclk, uint32_t hclk) {
+	uint8_t use_pll = (pConfig->RCC_SYSCLK_SOURCE == RCC_SYSCLK_SOURCE_PLL);
+	uint8_t use_hse = (pConfig->RCC_SYSCLK_SOURCE == RCC_SYSCLK_SOURCE_HSE)
+			|| (use_pll && pConfig->RCC_PLL_SOURCE == RCC_PLL_SOURCE_HSE);
+
+	/** 2. Oscillators */
+	RCC->CR |= (1UL << RCC_CR_HSION_Pos);
+	rcc_wait(1UL << RCC_CR_HSIRDY_Pos, 1UL << RCC_CR_HSIRDY_Pos);
+	if (use_hse) {
+		RCC->CR |= (1UL << RCC_CR_HSEON_Pos);
+		if (!rcc_wait(1UL << RCC_CR_HSERDY_Pos, 1UL << RCC_CR_HSERDY_Pos)) {
+			/** Not ready, so not in use by the current clock either */
+			RCC->CR &= ~(1UL << RCC_CR_HSEON_Pos);
+			return RCC_ERR_HSE_TIMEOUT;
+		}
+	}
+
+	/** 3. Wait states for the faster of old and new HCLK */
+	uint32_t hclk_old = rcc_get_hclk();
+	if (hclk > hclk_old) {
+		flash_set_latency(flash_latency_for_hclk(hclk));
+	}
+
+	/** 4. HSI while the PLL is stopped; PLLCFGR is read-only with PLLON set */
+	rcc_switch_sysclk(RCC_SYSCLK_SOURCE_HSI);
+	RCC->CR &= ~(1UL << RCC_CR_PLLON_Pos);
+	rcc_wait(1UL << RCC_CR_PLLRDY_Pos, 0);
+
+	/** Regulator scale 1 only above 144 MHz, scale 2 draws less; changed while the PLL is off */
+	RCC->APB1ENR |= (1UL << RCC_APB1ENR_PWR_EN_Pos);
+	if (sysclk > RCC_VOS_SCALE2_MAX_HZ) {
+		PWR->CR |= (1UL << PWR_CR_VOS_Pos);
+	} else {
+		PWR->CR &= ~(1UL << PWR_CR_VOS_Pos);
+	}
+	if (use_pll) {
+		RCC->PLLCFGR = ((uint32_t) pConfig->RCC_PLL_M << RCC_PLLCFGR_PLLM_Pos)
+				| ((uint32_t) pConfig->RCC_PLL_N << RCC_PLLCFGR_PLLN_Pos)
+				| ((uint32_t) ((pConfig->RCC_PLL_P >> 1) - 1U) << RCC_PLLCFGR_PLLP_Pos)
+				| ((uint32_t) pConfig->RCC_PLL_SOURCE << RCC_PLLCFGR_PLLSRC_Pos)
+				| ((uint32_t) pConfig->RCC_PLL_Q << RCC_PLLCFGR_PLLQ_Pos);
+		RCC->CR |= (1UL << RCC_CR_PLLON_Pos);
+		if (!rcc_wait(1UL << RCC_CR_PLLRDY_Pos, 1UL << RCC_CR_PLLRDY_Pos)) {
+			RCC->CR &= ~(1UL << RCC_CR_PLLON_Pos);
+			if (hclk > hclk_old) {
+				flash_set_latency(flash_latency_for_hclk(rcc_get_hclk()));
+			}
+			return RCC_ERR_PLL_TIMEOUT;
+		}
+	}
+
+	/** 5. APB buses parked at /16 so no HPRE/SW step can overclock them */
+	uint32_t cfgr = RCC->CFGR;
+	cfgr &= ~((0xFUL << RCC_CFGR_HPRE_Pos) | (0x7UL << RCC_CFGR_PPRE1_Pos) | (0x7UL << RCC_CFGR_PPRE2_Pos));
+	RCC->CFGR = cfgr | ((uint32_t) RCC_APB_DIV_16 << RCC_CFGR_PPRE1_Pos)
+			| ((uint32_t) RCC_APB_DIV_16 << RCC_CFGR_PPRE2_Pos)
+			| ((uint32_t) pConfig->RCC_AHB_PRESC << RCC_CFGR_HPRE_Pos);
+	rcc_switch_sysclk(pConfig->RCC_SYSCLK_SOURCE);
+	cfgr = RCC->CFGR & ~((0x7UL << RCC_CFGR_PPRE1_Pos) | (0x7UL << RCC_CFGR_PPRE2_Pos));
+	RCC->CFGR = cfgr | ((uint32_t) pConfig->RCC_APB1_PRESC << RCC_CFGR_PPRE1_Pos)
+			| ((uint32_t) pConfig->RCC_APB2_PRESC << RCC_CFGR_PPRE2_Pos);
+
+	/** 6. Fewer wait states once the clock is down, stop what is not used */
+	if (hclk <= hclk_old) {
+		flash_set_latency(flash_latency_for_hclk(hclk));
+	}
+	if (!use_hse) {
+		RCC->CR &= ~(1UL << RCC_CR_HSEON_Pos);
+	}
+	return RCC_OK;
+}
+
+/*
+ * Clock change hooks, called in registration order.
+ */
+static struct {
+	RCC_ClockHook_t hook;
+	void *pContext;
+} rcc_hook_table[RCC_CLOCK_HOOK_MAX];
+
+static void rcc_clock_notify(uint8_t Phase, uint32_t Count) {
+	for (uint32_t i = 0; i < Count; i++) {
+		if (rcc_hook_table[i].hook) {
+			(void)rcc_hook_table[i].hook(Phase, rcc_hook_table[i].pContext);
+		}
+	}
+}
+
+/*
+ * PRE to every hook. The first one refusing stops the walk and the hooks
+ * before it, which already paused, get ABORT.
+ */
+static uint8_t rcc_clock_prepare(void) {
+	for (uint32_t i = 0; i < RCC_CLOCK_HOOK_MAX; i++) {
+		if (rcc_hook_table[i].hook
+				&& rcc_hook_table[i].hook(RCC_CLOCK_CHANGE_PRE, rcc_hook_table[i].pContext) != RCC_OK) {
+			rcc_clock_notify(RCC_CLOCK_CHANGE_ABORT, i);
+			return RCC_ERR_BUSY;
+		}
+	}
+	return RCC_OK;
+}
+
+uint8_t rcc_clock_config(const RCC_Config_t *pConfig) {
+	/** 1. Target clocks, refuse anything outside the datasheet limits */
+	uint32_t sysclk = rcc_config_sysclk(pConfig);
+	uint32_t hclk = sysclk >> rcc_ahb_shift[pConfig->RCC_AHB_PRESC & 0xFU];
+	if (sysclk == 0 || sysclk > RCC_SYSCLK_MAX_HZ
+			|| (hclk >> rcc_apb_shift[pConfig->RCC_APB1_PRESC & 0x7U]) > RCC_PCLK1_MAX_HZ
+			|| (hclk >> rcc_apb_shift[pConfig->RCC_APB2_PRESC & 0x7U]) > RCC_PCLK2_MAX_HZ) {
+		return RCC_ERR_PARAM;
+	}
+
+	/** POST follows an accepted PRE, also on a failed switch (clocks may be on HSI then) */
+	if (rcc_clock_prepare() != RCC_OK) {
+		return RCC_ERR_BUSY;
+	}
+	uint8_t status = rcc_clock_switch(pConfig, sysclk, hclk);
+	rcc_clock_notify(RCC_CLOCK_CHANGE_POST, RCC_CLOCK_HOOK_MAX);
+	return status;
+}
+
+/** RCC_PRESET_* configurations, all PLL presets keep VCO = 336 MHz and 48 MHz on Q */
+static const RCC_Config_t rcc_presets[RCC_PRESET_COUNT] = {
+	[RCC_PRESET_168MHZ] = { RCC_SYSCLK_SOURCE_PLL, RCC_PLL_SOURCE_HSE, 8, 336, 2, 7,
+			RCC_AHB_DIV_1, RCC_APB_DIV_4, RCC_APB_DIV_2 },
+	[RCC_PRESET_84MHZ]  = { RCC_SYSCLK_SOURCE_PLL, RCC_PLL_SOURCE_HSE, 8, 336, 4, 7,
+			RCC_AHB_DIV_1, RCC_APB_DIV_2, RCC_APB_DIV_1 },
+	[RCC_PRESET_16MHZ]  = { RCC_SYSCLK_SOURCE_HSI, RCC_PLL_SOURCE_HSI, 16, 192, 2, 4,
+			RCC_AHB_DIV_1, RCC_APB_DIV_1, RCC_APB_DIV_1 },
+};
+
+uint8_t rcc_set_preset(uint8_t Preset) {
+	if (Preset >= RCC_PRESET_COUNT) {
+		return RCC_ERR_PARAM;
+	}
+	return rcc_clock_config(&rcc_presets[Preset]);
+}
+
+uint8_t rcc_clock_hook_register(RCC_ClockHook_t Hook, void *pContext) {
+	for (uint32_t i = 0; i < RCC_CLOCK_HOOK_MAX; i++) {
+		if (rcc_hook_table[i].hook == NULL) {
+			rcc_hook_table[i].pContext = pContext;
+			rcc_hook_table[i].hook = Hook;
+			return RCC_OK;
+		}
+	}
+	return RCC_ERR_HOOK_FULL;
+}
+
+void rcc_clock_hook_unregister(RCC_ClockHook_t Hook, void *pContext) {
+	for (uint32_t i = 0; i < RCC_CLOCK_HOOK_MAX; i++) {
+		if (rcc_hook_table[i].hook == Hook && rcc_hook_table[i].pContext == pContext) {
+			rcc_hook_table[i].hook = NULL;
+		}
+	}
+}
+
+uint32_t rcc_get_sysclk(void) {
+	uint32_t sws = (RCC->CFGR >> RCC_CFGR_SWS_Pos) & 0x3UL;
+
+	if (sws == RCC_SYSCLK_SOURCE_HSE) {
+		return RCC_HSE_VALUE;
+	} else if (sws == RCC_SYSCLK_SOURCE_PLL) {
+		uint32_t pllcfgr = RCC->PLLCFGR;
+		uint32_t src = (pllcfgr & (1UL << RCC_PLLCFGR_PLLSRC_Pos)) ? RCC_HSE_VALUE : RCC_HSI_VALUE;
+		uint32_t m = (pllcfgr >> RCC_PLLCFGR_PLLM_Pos) & 0x3FUL;
+		uint32_t n = (pllcfgr >> RCC_PLLCFGR_PLLN_Pos) & 0x1FFUL;
+		uint32_t p = (((pllcfgr >> RCC_PLLCFGR_PLLP_Pos) & 0x3UL) + 1U) << 1;
+		return ((src / m) * n) / p;
+	}
+	return RCC_HSI_VALUE;
+}
+
+uint32_t rcc_get_hclk(void) {
+	return rcc_get_sysclk() >> rcc_ahb_shift[(RCC->CFGR >> RCC_CFGR_HPRE_Pos) & 0xFUL];
+}
+
+uint32_t rcc_get_pclk1(void) {
+	return rcc_get_hclk() >> rcc_apb_shift[(RCC->CFGR >> RCC_CFGR_PPRE1_Pos) & 0x7UL];
+}
+
+uint32_t rcc_get_pclk2(void) {
+	return rcc_get_hclk() >> rcc_apb_shift[(RCC->CFGR >> RCC_CFGR_PPRE2_Pos) & 0x7UL];
+}
+
+uint32_t rcc_get_bus_clock(uint8_t RccId) {
+	uint32_t bus = (uint32_t) RccId >> 5;
+	if (bus == RCC_BUS_APB1) {
+		return rcc_get_pclk1();
+	} else if (bus == RCC_BUS_APB2) {
+		return rcc_get_pclk2();
+	}
+	return rcc_get_hclk();
+}
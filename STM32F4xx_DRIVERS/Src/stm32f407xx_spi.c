@@ -7,155 +7,246 @@
 
 #include "stm32f407xx_spi.h"
 
+/*
+ * Per-instance data: RCC clock/reset id and DMA request mapping
+ * (RM0090 table 42/43).
+ */
+typedef struct {
+	SPIx_RegDef_t *pSPIx;
+	uint8_t RccId;
+	DMA_RegDef_t *pDMAx;
+	uint8_t TxStream;
+	uint8_t RxStream;
+	uint8_t Channel;
+} spi_instance_t;
+
+static const spi_instance_t spi_instances[] = {
+	{ SPI1, RCC_PERIPH_ID(RCC_BUS_APB2, 12), DMA2, 3, 0, DMA_CHANNEL_3 },
+	{ SPI2, RCC_PERIPH_ID(RCC_BUS_APB1, 14), DMA1, 4, 3, DMA_CHANNEL_0 },
+	{ SPI3, RCC_PERIPH_ID(RCC_BUS_APB1, 15), DMA1, 5, 0, DMA_CHANNEL_0 },
+};
+
+static const spi_instance_t* spi_instance_lookup(SPIx_RegDef_t *pSPIx){
+	for(uint32_t i = 0; i < sizeof(spi_instances) / sizeof(spi_instances[0]); i++){
+		if(spi_instances[i].pSPIx == pSPIx){
+			return &spi_instances[i];
+		}
+	}
+	return NULL;
+}
+
 void SPIx_Init(SPIx_Handle_t *pSPI_Handle){
 	SPIx_RegDef_t* pSPIx = pSPI_Handle->pSPIx;
-	uint8_t SPI_DEVICE_MODE = pSPI_Handle->SPI_CONFIG.SPI_DEVICE_MODE;
-	uint8_t SPI_BUS_MODE = pSPI_Handle->SPI_CONFIG.SPI_BUS_MODE;
-	uint8_t SPI_CLOCK_SPEED = pSPI_Handle->SPI_CONFIG.SPI_CLOCK_SPEED;
-	uint8_t SPI_CPOL = pSPI_Handle->SPI_CONFIG.SPI_CPOL;
-	uint8_t SPI_CPHA = pSPI_Handle->SPI_CONFIG.SPI_CPHA;
-	uint8_t SPI_FRAME_SIZE = pSPI_Handle->SPI_CONFIG.SPI_FRAME_SIZE;
-	uint8_t SPI_SSM_SETTING = pSPI_Handle->SPI_CONFIG.SPI_SSM_SETTING;
-	uint8_t SPI_BIT_ORDER = pSPI_Handle->SPI_CONFIG.SPI_BIT_ORDER;
-	uint8_t SPI_SSOE = pSPI_Handle->SPI_CONFIG.SPI_SSOE;
-	uint8_t SPI_CRC_EN = pSPI_Handle->SPI_CONFIG.SPI_CRC_EN;
+	SPIx_ConfigImage_t image;
 
 	/** 1. Enable the SPIx peripheral clock Through RCC */
-	RCC_RegDef_t* pRCC = RCC;
-	if(pSPIx == SPI1){ /** Enable the SPI1 RCC APB2ENR reg */
-		pRCC->APB2ENR |= (1 << 12);
-	}else if(pSPIx == SPI2){/** Enable the SPI2 RCC APB1ENR reg */
-		pRCC->APB1ENR |= (1 << 14);
-	}else if(pSPIx == SPI3){/** Enable the SPI3 RCC APB1ENR reg */
-		pRCC->APB1ENR |= (1 << 15);
-	}
-
-	/** 2. Set Device Mode Master/Slave (MSTR)	 */
-	pSPIx->CR1 &= ~(1 << SPI_CR1_MSTR_Pos);
-	pSPIx->CR1 |= (SPI_DEVICE_MODE << SPI_CR1_MSTR_Pos);
-
-	/** 3. Set Bus Mode (Full Duplex/Half Duplex/Simplex)	 */
-	if (SPI_BUS_MODE == SPI_BUS_MODE_FULL_DUPLEX) { // Normal Mode
-		//Clear BIDIMODE Bit in CR1 Reg
-		pSPIx->CR1 &= ~(1 << SPI_CR1_BIDIMODE_Pos);
-		// Also Clear the RXONLY Bit just for safety
-		pSPIx->CR1 &= ~(1 << SPI_CR1_RXONLY_Pos);
-	}else if(SPI_BUS_MODE == SPI_BUS_MODE_HALF_DUPLEX){
-		//Set BIDIMODE Bit in CR1 Reg
-		/** @todo Implement later you should make seperate API for BIDIOE Bit */
-		pSPIx->CR1 |= (1 << SPI_CR1_BIDIMODE_Pos);
-	}else if(SPI_BUS_MODE == SPI_BUS_MODE_SIMPLEX_RX){// Simplex Means either Tx only or Rx Only
-		/** Clear this bit and use RX only for setting
-		 * 	@note Master can be in RX only mode as well, its not necessary that master has to be in TX only in Simplex mode
-		 * 	@note For simplex mode BIDIMODE Bit has to be Cleared
-		 */
-		pSPIx->CR1 &= ~(1 << SPI_CR1_BIDIMODE_Pos);
-		pSPIx->CR1 |= (1 << SPI_CR1_RXONLY_Pos);
-	}
-
-	/** 4. Select the BR[2:0] bits to define the serial clock baud rate (see SPI_CR1 register). */
-	pSPIx->CR1 &= ~(0x07 << 3); /*!< Clear the bits BR[2:0] first */
-	pSPIx->CR1 |= (SPI_CLOCK_SPEED << 3); /*!< Set the bits @ref SPI_CLOCK_SPEED_MACROS*/
-
-	/** 5. Select the CPOL and CPHA bits to define one of the four relationships between the
-	* data transfer and the serial clock (see Figure 248). This step is not required when the
-	* TI mode is selected.
-    */
-	pSPIx->CR1 &= ~(1 << SPI_CR1_CPHA_Pos); 	/*!< Clear CPHA */
-	pSPIx->CR1 &= ~(1 << SPI_CR1_CPOL_Pos);		/*!< Clear CPOL */
-	pSPIx->CR1 |= (SPI_CPHA << SPI_CR1_CPHA_Pos); 		/*!< Set CPHA */
-	pSPIx->CR1 |= (SPI_CPOL << SPI_CR1_CPOL_Pos);		/*!< Set CPOL */
-
-	/** 6. Set the DFF bit to define 8- or 16-bit data frame format */
-	pSPIx->CR1 &= ~(1 << SPI_CR1_DFF_Pos); /*!< Clear DFF */
-	pSPIx->CR1 |= (SPI_FRAME_SIZE << SPI_CR1_DFF_Pos); /*!< Set DFF */
-
-	/** 7. Configure the LSBFIRST bit in the SPI_CR1 register to define the frame format. */
-	pSPIx->CR1 &= ~(1 << SPI_CR1_LSBFIRST_Pos);
-	pSPIx->CR1 |= (SPI_BIT_ORDER << SPI_CR1_LSBFIRST_Pos);
-
-	/** 8. If the NSS pin is required in input mode, in hardware mode, connect the NSS pin to a
-	* high-level signal during the complete byte transmit sequence. In NSS software mode,
-	* set the SSM and SSI bits in the SPI_CR1 register. If the NSS pin is required in output
-	* mode, the SSOE bit only should be set. This step is not required when the TI mode is
-	* selected.
-	*/
-	pSPIx->CR1 &= ~(1 << SPI_CR1_SSM_Pos); // Clear the SSM Bit in CR1 Reg
-	pSPIx->CR1 |= (SPI_SSM_SETTING << SPI_CR1_SSM_Pos);// Set the bit
-
-	pSPIx->CR2 &= ~(1 << SPI_CR2_SSOE_Pos);	// Clear the SSOE Bit in CR2 Reg
-	pSPIx->CR2 |= (SPI_SSOE << SPI_CR2_SSOE_Pos);// Set the bit
-
-	/** 9. Set the FRF bit in SPI_CR2 to select the TI protocol for serial communications */
-	/**@todo implement CRC_EN and FRF */
+	const spi_instance_t *pInst = spi_instance_lookup(pSPIx);
+	if(pInst == NULL){
+		return;
+	}
+	RCC_PERIPH_CLK_EN(pInst->RccId);
+
+	/** 2. Build CR1/CR2/CRCPR and write each register once */
+	SPIx_CompileConfig(&pSPI_Handle->SPI_CONFIG, &image);
+	SPIx_ApplyConfig(pSPIx, &image);
+}
+
+void SPIx_CompileConfig(const SPIx_Config_t *pConfig, SPIx_ConfigImage_t *pImage){
+	/** Configuration sequence of RM0090 28.3.3 "Configuring the SPI in master mode":
+	 *  1. MSTR: device mode
+	 *  2. BIDIMODE/RXONLY: full duplex, half duplex (BIDIOE is set per transfer) or simplex RX
+	 *  3. BR[2:0]: baud rate
+	 *  4. CPOL/CPHA: clock/data relationship (not used in TI mode)
+	 *  5. DFF: 8- or 16-bit frames
+	 *  6. LSBFIRST: bit order (not used in TI mode)
+	 *  7. SSM/SSI: software NSS, SSI=1 for a master. SSOE: hardware NSS output (not used in TI mode)
+	 *  8. FRF: TI frame format
+	 *  9. CRCEN and CRCPR */
+	pImage->CR1 = SPI_CONFIG_CR1(pConfig->SPI_DEVICE_MODE, pConfig->SPI_BUS_MODE, pConfig->SPI_CLOCK_SPEED,
+			pConfig->SPI_CPOL, pConfig->SPI_CPHA, pConfig->SPI_FRAME_SIZE, pConfig->SPI_BIT_ORDER,
+			pConfig->SPI_SSM_SETTING, pConfig->SPI_CRC_EN);
+	pImage->CR2 = SPI_CONFIG_CR2(pConfig->SPI_SSOE, pConfig->SPI_FRAME_FORMAT);
+	if(pConfig->SPI_FRAME_FORMAT == SPI_FRAME_FORMAT_TI){
+		pImage->CR1 &= ~SPI_CONFIG_CR1_TI_UNUSED;
+	}
+	pImage->CRCPR = pConfig->SPI_CRC_POLYNOMIAL ? pConfig->SPI_CRC_POLYNOMIAL : SPI_CRC_POLYNOMIAL_DEFAULT;
+}
+
+void SPIx_ApplyConfig(SPIx_RegDef_t *pSPIx, const SPIx_ConfigImage_t *pImage){
+	/** 1. Mode, baud, DFF and CRCEN may only change with SPE=0 */
+	uint32_t cr1 = pSPIx->CR1;
+	if(cr1 & (1U << SPI_CR1_SPE_Pos)){
+		pSPIx->CR1 = cr1 & ~(1U << SPI_CR1_SPE_Pos);
+	}
+	/** 2. Polynomial before CRCEN is set */
+	if(pImage->CR1 & (1U << SPI_CR1_CRCEN_Pos)){
+		pSPIx->CRCPR = pImage->CRCPR;
+	}
+	/** 3. CR2 keeps its interrupt/DMA enables */
+	pSPIx->CR2 = (pSPIx->CR2 & ~SPI_CONFIG_CR2_MASK) | pImage->CR2;
+	pSPIx->CR1 = pImage->CR1;
 }
 
 void SPIx_DeInit(SPIx_RegDef_t *pSPIx)
 {
-    RCC_RegDef_t *pRCC = RCC;
-
-    if (pSPIx == SPI1)
+    const spi_instance_t *pInst = spi_instance_lookup(pSPIx);
+    if (pInst == NULL)
     {
-        pRCC->APB2RSTR |=  (1 << 12);   // Force reset
-        pRCC->APB2RSTR &= ~(1 << 12);   // Release reset
-    }
-    else if (pSPIx == SPI2)
-    {
-        pRCC->APB1RSTR |=  (1 << 14);   // Force reset
-        pRCC->APB1RSTR &= ~(1 << 14);   // Release reset
-    }
-    else if (pSPIx == SPI3)
-    {
-        pRCC->APB1RSTR |=  (1 << 15);   // Force reset
-        pRCC->APB1RSTR &= ~(1 << 15);   // Release reset
+        return;
     }
+    /** 1. Force and release the reset */
+    RCC_PERIPH_RESET(pInst->RccId);
 
     /** 2. Disable peripheral clock to save power */
-       if (pSPIx == SPI1)
-       {
-           pRCC->APB2ENR &= ~(1 << 12);
-       }
-       else if (pSPIx == SPI2)
-       {
-           pRCC->APB1ENR &= ~(1 << 14);
-       }
-       else if (pSPIx == SPI3)
-       {
-           pRCC->APB1ENR &= ~(1 << 15);
-       }
+    RCC_PERIPH_CLK_DI(pInst->RccId);
 }
 
 void SPIx_Peri_Control(SPIx_RegDef_t *pSPIx, uint8_t EN_DI){
 	if(EN_DI == ENABLE){
-		pSPIx->CR1 |= (1 << SPI_CR1_SPE_Pos);
+		PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
 	}else{
 		//	1. Wait until TXE=1
 		while(!SPIx_GetFlagStatus(pSPIx, SPI_STATUS_FLAG_TXE));
 		// 	2. Then wait until BSY=0
 		while(SPIx_GetFlagStatus(pSPIx, SPI_STATUS_FLAG_BSY));
 		// 	3. The Disable the SPI
-		pSPIx->CR1 &= ~(1 << SPI_CR1_SPE_Pos);
+		PERIPH_BIT_CLR(pSPIx->CR1, SPI_CR1_SPE_Pos);
+	}
+}
+
+void SPIx_ResetCRC(SPIx_RegDef_t *pSPIx){
+	if(pSPIx->CR1 & (1 << SPI_CR1_CRCEN_Pos)){
+		/** CRCEN may only be written with SPE=0 (RM0090), SPE is restored afterwards */
+		uint8_t spe = (pSPIx->CR1 & (1U << SPI_CR1_SPE_Pos)) ? 1 : 0;
+		if(spe){
+			while(pSPIx->SR & (1U << SPI_SR_BSY_Pos));
+			PERIPH_BIT_CLR(pSPIx->CR1, SPI_CR1_SPE_Pos);
+		}
+		pSPIx->CR1 &= ~(1 << SPI_CR1_CRCEN_Pos);
+		pSPIx->CR1 |= (1 << SPI_CR1_CRCEN_Pos);
+		if(spe){
+			PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
+		}
+	}
+}
+
+uint32_t SPIx_GetBaudRate(SPIx_RegDef_t *pSPIx){
+	const spi_instance_t *pInst = spi_instance_lookup(pSPIx);
+	if(pInst == NULL){
+		return 0;
+	}
+	/** SCK = PCLK / 2^(BR+1) */
+	return rcc_get_bus_clock(pInst->RccId) >> (((pSPIx->CR1 >> SPI_CR1_BR_Pos) & 0x7U) + 1U);
+}
+
+uint8_t SPIx_ComputeClockSpeed(SPIx_RegDef_t *pSPIx, uint32_t MaxBaudHz){
+	const spi_instance_t *pInst = spi_instance_lookup(pSPIx);
+	uint32_t pclk = pInst ? rcc_get_bus_clock(pInst->RccId) : 0;
+	uint8_t br = SPI_CLOCK_SPEED_BY_2;
+
+	while(br < SPI_CLOCK_SPEED_BY_256 && (pclk >> (br + 1U)) > MaxBaudHz){
+		br++;
+	}
+	return br;
+}
+
+uint32_t SPIx_SetBaudRate(SPIx_RegDef_t *pSPIx, uint32_t MaxBaudHz){
+	uint32_t br = SPIx_ComputeClockSpeed(pSPIx, MaxBaudHz);
+	uint32_t cr1 = pSPIx->CR1;
+
+	/** BR must not change while SPE=1 with a frame in flight */
+	if(cr1 & (1U << SPI_CR1_SPE_Pos)){
+		while(pSPIx->SR & (1U << SPI_SR_BSY_Pos));
+		PERIPH_BIT_CLR(pSPIx->CR1, SPI_CR1_SPE_Pos);
+	}
+	cr1 = (cr1 & ~(0x7U << SPI_CR1_BR_Pos)) | (br << SPI_CR1_BR_Pos);
+	pSPIx->CR1 = cr1;
+	return SPIx_GetBaudRate(pSPIx);
+}
+
+static uint8_t spi_clock_hook(uint8_t Phase, void *pContext){
+	SPIx_Handle_t *pSPI_Handle = (SPIx_Handle_t*)pContext;
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+
+	if(!(pSPIx->CR1 & (1U << SPI_CR1_MSTR_Pos)) || pSPI_Handle->BusOwned){
+		return RCC_OK; /** A slave follows the master's SCK, a bus has its own hook */
+	}
+	if(Phase == RCC_CLOCK_CHANGE_PRE){
+		/** No frame may be clocked while PCLK and BR disagree: refuse rather than wait */
+		if(pSPI_Handle->TxState != SPI_STATE_READY || pSPI_Handle->RxState != SPI_STATE_READY
+				|| pSPI_Handle->DmaXfer != SPI_DMA_XFER_NONE || (pSPIx->SR & (1U << SPI_SR_BSY_Pos))){
+			return RCC_ERR_BUSY;
+		}
+	}else if(Phase == RCC_CLOCK_CHANGE_POST){
+		pSPI_Handle->SPI_CONFIG.SPI_CLOCK_SPEED = SPIx_ComputeClockSpeed(pSPIx, pSPI_Handle->MaxBaudHz);
+		SPIx_SetBaudRate(pSPIx, pSPI_Handle->MaxBaudHz);
+	}
+	return RCC_OK;
+}
+
+uint8_t SPIx_RegisterClockHook(SPIx_Handle_t *pSPI_Handle, uint32_t MaxBaudHz){
+	if(pSPI_Handle->BusOwned){
+		return RCC_ERR_PARAM;
 	}
+	pSPI_Handle->MaxBaudHz = MaxBaudHz;
+	(void)spi_clock_hook(RCC_CLOCK_CHANGE_POST, pSPI_Handle);
+	return rcc_clock_hook_register(spi_clock_hook, pSPI_Handle);
+}
+
+/** CRCERR is rc_w0: write 0 to clear. Returns 1 if it was set. */
+static uint8_t spi_crc_error_clear(SPIx_RegDef_t *pSPIx){
+	if(pSPIx->SR & (1 << SPI_SR_CRCERR_Pos)){
+		pSPIx->SR = ~(1U << SPI_SR_CRCERR_Pos);
+		return 1;
+	}
+	return 0;
 }
 
 uint8_t SPIx_GetFlagStatus(SPIx_RegDef_t *pSPIx, uint32_t FlagName) {
 	return (uint8_t) (((pSPIx->SR) >> FlagName) & (0x01U));
 }
 
-void SPIx_SendData_Blocking(SPIx_RegDef_t *pSPIx, uint8_t* pData, uint32_t Len){
-	while(Len>0){
+/*
+ * Frame-size specialised send loops, selected once per call.
+ * The 16-bit loop builds each frame from two bytes, so the buffer may be
+ * unaligned, and sends an odd trailing byte as the low byte of a last frame.
+ */
+static void spi_send_8(SPIx_RegDef_t *pSPIx, const uint8_t *pData, uint32_t Len){
+	while(Len--){
 		// Wait until TXE = 1
-		while (!SPIx_GetFlagStatus(pSPIx, SPI_STATUS_FLAG_TXE));
-		//Check the data format
-		if(pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)){// Frame Size = 16
-			pSPIx->DR = *((uint16_t*) pData);
-			pData += 2;
-			Len -= 2;
-		}else{// Frame Size = 8
-			pSPIx->DR = *pData;
-			pData++;
-			Len--;
-		}
+		while (!(pSPIx->SR & (1 << SPI_SR_TXE_Pos)));
+		pSPIx->DR = *pData++;
+	}
+}
+
+static void spi_send_16(SPIx_RegDef_t *pSPIx, const uint8_t *pData, uint32_t Len){
+	while(Len >= 2){
+		// Wait until TXE = 1
+		while (!(pSPIx->SR & (1 << SPI_SR_TXE_Pos)));
+		pSPIx->DR = (uint16_t)(pData[0] | (pData[1] << 8));
+		pData += 2;
+		Len -= 2;
+	}
+	if(Len){// Odd tail
+		while (!(pSPIx->SR & (1 << SPI_SR_TXE_Pos)));
+		pSPIx->DR = pData[0];
+	}
+}
+
+void SPIx_SendData_Blocking(SPIx_RegDef_t *pSPIx, uint8_t* pData, uint32_t Len){
+	uint8_t crc = (pSPIx->CR1 & (1U << SPI_CR1_CRCEN_Pos)) ? 1 : 0;
+	if(crc){
+		SPIx_ResetCRC(pSPIx);
+	}
+	//Check the data format once, not per frame
+	if(pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)){// Frame Size = 16
+		spi_send_16(pSPIx, pData, Len);
+	}else{// Frame Size = 8
+		spi_send_8(pSPIx, pData, Len);
+	}
+	if(crc){
+		/** Last data frame is in DR: the CRC frame follows it */
+		pSPIx->CR1 |= (1U << SPI_CR1_CRCNEXT_Pos);
 	}
 
 
@@ -167,3 +258,885 @@ void SPIx_SendData_Blocking(SPIx_RegDef_t *pSPIx, uint8_t* pData, uint32_t Len){
     while (!SPIx_GetFlagStatus(pSPIx, SPI_STATUS_FLAG_TXE));
     while  ( SPIx_GetFlagStatus(pSPIx, SPI_STATUS_FLAG_BSY));
 }
+
+/*
+ * Pipelined full-duplex loops, one per frame size so the DFF test is done
+ * once per call. "in flight" counts frames written to DR but not yet read
+ * back: allowing two keeps the shift register busy while the next frame
+ * waits in DR, and never lets a third frame overwrite an unread RXNE.
+ */
+static void spi_txrx_8(SPIx_RegDef_t *pSPIx, const uint8_t *pTx, uint8_t *pRx, uint32_t Len, uint8_t crc){
+	uint32_t tx_left = Len;
+	uint32_t rx_left = Len;
+
+	while(rx_left){
+		uint32_t sr = pSPIx->SR;
+		if((sr & (1 << SPI_SR_TXE_Pos)) && tx_left && (rx_left - tx_left) < 2){
+			pSPIx->DR = pTx ? *pTx++ : 0xFF;
+			tx_left--;
+			if(!tx_left && crc){
+				pSPIx->CR1 |= (1U << SPI_CR1_CRCNEXT_Pos);
+			}
+		}
+		if(sr & (1 << SPI_SR_RXNE_Pos)){
+			uint8_t frame = (uint8_t)pSPIx->DR;
+			if(pRx){
+				*pRx++ = frame;
+			}
+			rx_left--;
+		}
+	}
+}
+
+static void spi_txrx_16(SPIx_RegDef_t *pSPIx, const uint8_t *pTx, uint8_t *pRx, uint32_t Len, uint8_t crc){
+	uint32_t frames = (Len + 1) / 2;
+	uint32_t tx_left = frames;
+	uint32_t rx_left = frames;
+	uint8_t odd = (uint8_t)(Len & 1);
+
+	while(rx_left){
+		uint32_t sr = pSPIx->SR;
+		if((sr & (1 << SPI_SR_TXE_Pos)) && tx_left && (rx_left - tx_left) < 2){
+			uint16_t frame = 0xFFFF;
+			if(pTx){
+				frame = (tx_left == 1 && odd) ? pTx[0] : (uint16_t)(pTx[0] | (pTx[1] << 8));
+				pTx += 2;
+			}
+			pSPIx->DR = frame;
+			tx_left--;
+			if(!tx_left && crc){
+				pSPIx->CR1 |= (1U << SPI_CR1_CRCNEXT_Pos);
+			}
+		}
+		if(sr & (1 << SPI_SR_RXNE_Pos)){
+			uint16_t frame = (uint16_t)pSPIx->DR;
+			if(pRx){
+				*pRx++ = (uint8_t)frame;
+				if(!(rx_left == 1 && odd)){
+					*pRx++ = (uint8_t)(frame >> 8);
+				}
+			}
+			rx_left--;
+		}
+	}
+}
+
+uint8_t SPIx_TransmitReceive(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer,
+		uint8_t *pRxBuffer, uint32_t Len){
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	uint8_t crc = (pSPIx->CR1 & (1U << SPI_CR1_CRCEN_Pos)) ? 1 : 0;
+
+	/** Drop a stale frame and OVR left behind by an earlier TX-only transfer */
+	(void)pSPIx->DR;
+	(void)pSPIx->SR;
+	if(crc){
+		SPIx_ResetCRC(pSPIx);
+	}
+
+	if(pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)){// Frame Size = 16
+		spi_txrx_16(pSPIx, pTxBuffer, pRxBuffer, Len, crc);
+	}else{// Frame Size = 8
+		spi_txrx_8(pSPIx, pTxBuffer, pRxBuffer, Len, crc);
+	}
+
+	if(crc){
+		/** The peer's CRC frame follows the data, read it to update CRCERR */
+		while(!(pSPIx->SR & (1 << SPI_SR_RXNE_Pos)));
+		(void)pSPIx->DR;
+		if(spi_crc_error_clear(pSPIx)){
+			return SPI_ERROR_CRC;
+		}
+	}
+	return SPI_ERROR_NONE;
+}
+
+/*
+ * Helpers used by the interrupt driven transfers.
+ * 16-bit frames are assembled byte by byte so the buffers do not need to be
+ * half-word aligned; a trailing odd byte goes out as the low byte of a frame.
+ */
+void SPIx_HalfDuplex_SetDirection(SPIx_RegDef_t *pSPIx, uint8_t Direction){
+	uint32_t cr1 = pSPIx->CR1;
+	/** BIDIOE is only changed with the SPI disabled */
+	if(cr1 & (1U << SPI_CR1_SPE_Pos)){
+		cr1 &= ~(1U << SPI_CR1_SPE_Pos);
+		pSPIx->CR1 = cr1;
+	}
+	if(Direction == SPI_HD_DIR_TX){
+		pSPIx->CR1 = cr1 | (1U << SPI_CR1_BIDIOE_Pos);
+	}else{
+		pSPIx->CR1 = cr1 & ~(1U << SPI_CR1_BIDIOE_Pos);
+	}
+}
+
+static uint8_t spi_is_hd_master_rx(SPIx_RegDef_t *pSPIx){
+	return (pSPIx->CR1 & ((1U << SPI_CR1_BIDIMODE_Pos) | (1U << SPI_CR1_BIDIOE_Pos) | (1U << SPI_CR1_MSTR_Pos)))
+			== ((1U << SPI_CR1_BIDIMODE_Pos) | (1U << SPI_CR1_MSTR_Pos));
+}
+
+/*
+ * CPU cycles in one SCK period, rounded up. Computed before the receive
+ * phase starts: at the fastest baud rates the clock lookups alone take
+ * longer than a frame. Also starts the DWT cycle counter the clock stop
+ * is timed with.
+ */
+static uint32_t spi_sck_cycles(SPIx_RegDef_t *pSPIx){
+	uint32_t sck = SPIx_GetBaudRate(pSPIx);
+
+	COREDEBUG->DEMCR |= (1U << COREDEBUG_DEMCR_TRCENA_Pos);
+	DWT->CTRL |= (1U << DWT_CTRL_CYCCNTENA_Pos);
+	if(sck == 0){
+		return 0;
+	}
+	return (rcc_get_hclk() + sck - 1U) / sck;
+}
+
+/*
+ * Master receive direction clocks while SPE=1. RM0090: after the
+ * second-to-last RXNE wait one SPI clock, so the last frame has started,
+ * then clear SPE; the frame in progress still completes. Start is the
+ * CYCCNT value at that RXNE (or at SPE=1 for a single frame): the deadline
+ * does not depend on flash wait states, and with interrupts masked the SPE
+ * clear lands a few cycles after one SCK period, well inside the 8 SCK of
+ * the last frame.
+ */
+static void spi_hd_stop_clock(SPIx_RegDef_t *pSPIx, uint32_t Start, uint32_t SckCycles){
+	while((DWT->CYCCNT - Start) < SckCycles);
+	PERIPH_BIT_CLR(pSPIx->CR1, SPI_CR1_SPE_Pos);
+}
+
+/*
+ * Turn the line around for the response. Waits for the command to leave the
+ * shift register first.
+ */
+static void spi_hd_turnaround(SPIx_RegDef_t *pSPIx){
+	while(!(pSPIx->SR & (1 << SPI_SR_TXE_Pos)));
+	while(pSPIx->SR & (1 << SPI_SR_BSY_Pos));
+	SPIx_HalfDuplex_SetDirection(pSPIx, SPI_HD_DIR_RX);
+	/** Nothing may be left in DR from before the turnaround */
+	(void)pSPIx->DR;
+	(void)pSPIx->SR;
+}
+
+uint8_t SPIx_HalfDuplex_TransmitReceive(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer,
+		uint32_t TxLen, uint8_t *pRxBuffer, uint32_t RxLen){
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	uint8_t dff16 = (pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)) ? 1 : 0;
+
+	/** A full-duplex SPE=1 receive generates no clock, RXNE would never come */
+	if(pSPI_Handle->SPI_CONFIG.SPI_BUS_MODE != SPI_BUS_MODE_HALF_DUPLEX){
+		return SPI_ERROR_NOT_STARTED;
+	}
+
+	/** 1. Command, BIDIOE=1 */
+	if(TxLen){
+		SPIx_HalfDuplex_SetDirection(pSPIx, SPI_HD_DIR_TX);
+		PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
+		if(dff16){
+			spi_send_16(pSPIx, pTxBuffer, TxLen);
+		}else{
+			spi_send_8(pSPIx, pTxBuffer, TxLen);
+		}
+	}
+	if(RxLen == 0){
+		while(!(pSPIx->SR & (1 << SPI_SR_TXE_Pos)));
+		while(pSPIx->SR & (1 << SPI_SR_BSY_Pos));
+		return SPI_ERROR_NONE;
+	}
+
+	/** 2. Response, BIDIOE=0. Enabling the SPI starts the clock of a master. */
+	uint8_t master = (pSPIx->CR1 & (1U << SPI_CR1_MSTR_Pos)) ? 1 : 0;
+	uint32_t frames = dff16 ? ((RxLen + 1) / 2) : RxLen;
+	uint32_t sck_cycles = master ? spi_sck_cycles(pSPIx) : 0;
+	uint32_t primask = 0;
+	spi_hd_turnaround(pSPIx);
+	if(master && frames == 1){
+		primask = nvic_irq_save();
+		PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
+		spi_hd_stop_clock(pSPIx, DWT->CYCCNT, sck_cycles);
+		nvic_irq_restore(primask);
+	}else{
+		PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
+	}
+	while(frames){
+		/** No interrupt between the second-to-last RXNE and the SPE clear */
+		if(master && frames == 2){
+			primask = nvic_irq_save();
+		}
+		while(!(pSPIx->SR & (1 << SPI_SR_RXNE_Pos)));
+		if(master && frames == 2){
+			spi_hd_stop_clock(pSPIx, DWT->CYCCNT, sck_cycles);
+			nvic_irq_restore(primask);
+		}
+		uint16_t frame = (uint16_t)pSPIx->DR;
+		*pRxBuffer++ = (uint8_t)frame;
+		if(dff16 && !(frames == 1 && (RxLen & 1U))){
+			*pRxBuffer++ = (uint8_t)(frame >> 8);
+		}
+		frames--;
+	}
+	/** 3. A slave keeps SPE until here */
+	PERIPH_BIT_CLR(pSPIx->CR1, SPI_CR1_SPE_Pos);
+	return SPI_ERROR_NONE;
+}
+
+static void spi_txe_interrupt_handle(SPIx_Handle_t *pSPI_Handle);
+static void spi_rxne_interrupt_handle(SPIx_Handle_t *pSPI_Handle);
+static void spi_ovr_interrupt_handle(SPIx_Handle_t *pSPI_Handle);
+
+/** Only a full-duplex master has to clock out frames to receive */
+static uint8_t spi_is_full_duplex_master(SPIx_RegDef_t *pSPIx){
+	return (pSPIx->CR1 & (1 << SPI_CR1_MSTR_Pos))
+			&& !(pSPIx->CR1 & ((1 << SPI_CR1_BIDIMODE_Pos) | (1 << SPI_CR1_RXONLY_Pos)));
+}
+
+static void spi_app_event(SPIx_Handle_t *pSPI_Handle, uint8_t AppEvent){
+	if(pSPI_Handle->AppEventCallback){
+		pSPI_Handle->AppEventCallback(pSPI_Handle, AppEvent);
+	}
+}
+
+uint8_t SPIx_SendData_IT(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer, uint32_t Len){
+	uint8_t state = pSPI_Handle->TxState;
+	if(state != SPI_STATE_READY){
+		return state;
+	}
+	if(Len == 0){
+		return SPI_NOT_STARTED; /** No TX_CMPLT would ever be reported */
+	}
+	/** 1. Save the buffer and length in the handle */
+	pSPI_Handle->pTxBuffer = pTxBuffer;
+	pSPI_Handle->TxLen = Len;
+	/** 2. Mark the handle busy so no other code can take over the peripheral */
+	pSPI_Handle->TxState = SPI_STATE_BUSY_IN_TX;
+	if(pSPI_Handle->RxState == SPI_STATE_READY){
+		SPIx_ResetCRC(pSPI_Handle->pSPIx);
+	}
+	/** 3. Enable TXEIE, the interrupt fires immediately as TXE is already set */
+	pSPI_Handle->pSPIx->CR2 |= (1 << SPI_CR2_TXEIE_Pos);
+	return state;
+}
+
+uint8_t SPIx_ReceiveData_IT(SPIx_Handle_t *pSPI_Handle, uint8_t *pRxBuffer, uint32_t Len){
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	uint8_t state = pSPI_Handle->RxState;
+	if(state != SPI_STATE_READY){
+		return state;
+	}
+	if(Len == 0){
+		return SPI_NOT_STARTED; /** No RX_CMPLT would ever be reported */
+	}
+	if(spi_is_hd_master_rx(pSPIx)){
+		pSPI_Handle->HdSckCycles = spi_sck_cycles(pSPIx); /** RXNE handler stops the clock */
+	}
+	pSPI_Handle->pRxBuffer = pRxBuffer;
+	pSPI_Handle->RxLen = Len;
+	pSPI_Handle->RxState = SPI_STATE_BUSY_IN_RX;
+
+	if(pSPI_Handle->TxState == SPI_STATE_READY){
+		/** Drop a stale frame and OVR left behind by an earlier TX-only transfer */
+		(void)pSPIx->DR;
+		(void)pSPIx->SR;
+		SPIx_ResetCRC(pSPIx);
+	}
+	pSPIx->CR2 |= (1 << SPI_CR2_RXNEIE_Pos) | (1 << SPI_CR2_ERRIE_Pos);
+
+	/** A full-duplex master has to generate the clock, send dummy frames */
+	if(spi_is_full_duplex_master(pSPIx) && pSPI_Handle->TxState == SPI_STATE_READY){
+		pSPI_Handle->pTxBuffer = NULL;
+		pSPI_Handle->TxLen = Len;
+		pSPI_Handle->TxState = SPI_STATE_BUSY_IN_TX;
+		pSPIx->CR2 |= (1 << SPI_CR2_TXEIE_Pos);
+	}
+	return state;
+}
+
+static void spi_hd_start_rx_it(SPIx_Handle_t *pSPI_Handle){
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	uint32_t frame_bytes = (pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)) ? 2 : 1;
+
+	pSPI_Handle->HdSckCycles = spi_sck_cycles(pSPIx);
+	spi_hd_turnaround(pSPIx);
+	pSPI_Handle->pRxBuffer = pSPI_Handle->pHdRxBuffer;
+	pSPI_Handle->RxLen = pSPI_Handle->HdRxLen;
+	pSPI_Handle->pHdRxBuffer = NULL;
+	pSPI_Handle->HdRxLen = 0;
+	pSPI_Handle->RxState = SPI_STATE_BUSY_IN_RX;
+	pSPIx->CR2 |= (1 << SPI_CR2_RXNEIE_Pos) | (1 << SPI_CR2_ERRIE_Pos);
+	if(spi_is_hd_master_rx(pSPIx) && pSPI_Handle->RxLen <= frame_bytes){
+		uint32_t primask = nvic_irq_save();
+		PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
+		spi_hd_stop_clock(pSPIx, DWT->CYCCNT, pSPI_Handle->HdSckCycles);
+		nvic_irq_restore(primask);
+	}else{
+		PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
+	}
+}
+
+uint8_t SPIx_HalfDuplex_TransmitReceive_IT(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer,
+		uint32_t TxLen, uint8_t *pRxBuffer, uint32_t RxLen){
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	if(pSPI_Handle->TxState != SPI_STATE_READY){
+		return pSPI_Handle->TxState;
+	}
+	if(pSPI_Handle->RxState != SPI_STATE_READY){
+		return pSPI_Handle->RxState;
+	}
+	if((TxLen == 0 && RxLen == 0) || pSPI_Handle->SPI_CONFIG.SPI_BUS_MODE != SPI_BUS_MODE_HALF_DUPLEX){
+		return SPI_NOT_STARTED;
+	}
+	/** 1. The receive phase waits in the handle until the TXE handler has sent the command */
+	pSPI_Handle->pHdRxBuffer = pRxBuffer;
+	pSPI_Handle->HdRxLen = RxLen;
+	if(TxLen == 0){
+		spi_hd_start_rx_it(pSPI_Handle);
+		return SPI_STATE_READY;
+	}
+	/** 2. Command, BIDIOE=1 */
+	SPIx_HalfDuplex_SetDirection(pSPIx, SPI_HD_DIR_TX);
+	pSPI_Handle->pTxBuffer = pTxBuffer;
+	pSPI_Handle->TxLen = TxLen;
+	pSPI_Handle->TxState = SPI_STATE_BUSY_IN_TX;
+	PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
+	pSPIx->CR2 |= (1 << SPI_CR2_TXEIE_Pos);
+	return SPI_STATE_READY;
+}
+
+ISR_RAMFUNC void SPIx_IRQHandling(SPIx_Handle_t *pSPI_Handle){
+	uint32_t sr = pSPI_Handle->pSPIx->SR;
+	uint32_t cr2 = pSPI_Handle->pSPIx->CR2;
+
+	/** 1. RXNE first, so a pending frame is read before OVR can build up */
+	if((sr & (1 << SPI_SR_RXNE_Pos)) && (cr2 & (1 << SPI_CR2_RXNEIE_Pos))){
+		spi_rxne_interrupt_handle(pSPI_Handle);
+	}
+	/** 2. TXE */
+	if((sr & (1 << SPI_SR_TXE_Pos)) && (cr2 & (1 << SPI_CR2_TXEIE_Pos))){
+		spi_txe_interrupt_handle(pSPI_Handle);
+	}
+	/** 3. Overrun error */
+	if((sr & (1 << SPI_SR_OVR_Pos)) && (cr2 & (1 << SPI_CR2_ERRIE_Pos))){
+		spi_ovr_interrupt_handle(pSPI_Handle);
+	}
+	/** 4. TI frame format error, cleared by the SR read above */
+	if((sr & (1 << SPI_SR_FRE_Pos)) && (cr2 & (1 << SPI_CR2_ERRIE_Pos))){
+		spi_app_event(pSPI_Handle, SPI_EVENT_FRE_ERR);
+	}
+}
+
+ISR_RAMFUNC static void spi_txe_interrupt_handle(SPIx_Handle_t *pSPI_Handle){
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	const uint8_t *pTx = pSPI_Handle->pTxBuffer;
+	uint8_t dummy = (pTx == NULL);
+
+	if(pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)){// Frame Size = 16
+		uint16_t frame = 0xFFFF;
+		uint32_t step = (pSPI_Handle->TxLen >= 2) ? 2 : 1;
+		if(!dummy){
+			frame = (step == 2) ? (uint16_t)(pTx[0] | (pTx[1] << 8)) : pTx[0];
+			pSPI_Handle->pTxBuffer += step;
+		}
+		pSPIx->DR = frame;
+		pSPI_Handle->TxLen -= step;
+	}else{// Frame Size = 8
+		pSPIx->DR = dummy ? 0xFF : *pTx;
+		if(!dummy){
+			pSPI_Handle->pTxBuffer++;
+		}
+		pSPI_Handle->TxLen--;
+	}
+
+	if(pSPI_Handle->TxLen == 0){
+		/** Last data frame is in DR: the CRC frame follows it */
+		if(pSPIx->CR1 & (1U << SPI_CR1_CRCEN_Pos)){
+			pSPIx->CR1 |= (1U << SPI_CR1_CRCNEXT_Pos);
+		}
+		/** Close the transmission */
+		pSPIx->CR2 &= ~(1 << SPI_CR2_TXEIE_Pos);
+		pSPI_Handle->pTxBuffer = NULL;
+		pSPI_Handle->TxState = SPI_STATE_READY;
+		if(pSPI_Handle->RxState == SPI_STATE_READY){
+			/** TX only: the unread frames raised OVR, clear it (read DR then SR) */
+			(void)pSPIx->DR;
+			(void)pSPIx->SR;
+		}
+		if(pSPI_Handle->HdRxLen){
+			/** Half-duplex: the response follows the command */
+			spi_hd_start_rx_it(pSPI_Handle);
+			return;
+		}
+		if(!dummy){
+			spi_app_event(pSPI_Handle, SPI_EVENT_TX_CMPLT);
+		}
+	}
+}
+
+ISR_RAMFUNC static void spi_rxne_interrupt_handle(SPIx_Handle_t *pSPI_Handle){
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+
+	if(pSPI_Handle->RxLen == 0){
+		/** All data stored, this is the CRC frame sent by the peer */
+		(void)pSPIx->DR;
+		pSPIx->CR2 &= ~((1 << SPI_CR2_RXNEIE_Pos) | (1 << SPI_CR2_ERRIE_Pos));
+		pSPI_Handle->RxState = SPI_STATE_READY;
+		if(spi_crc_error_clear(pSPIx)){
+			spi_app_event(pSPI_Handle, SPI_EVENT_CRC_ERR);
+		}
+		spi_app_event(pSPI_Handle, SPI_EVENT_RX_CMPLT);
+		return;
+	}
+
+	if(pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)){// Frame Size = 16
+		uint16_t frame = (uint16_t)pSPIx->DR;
+		*pSPI_Handle->pRxBuffer++ = (uint8_t)frame;
+		pSPI_Handle->RxLen--;
+		if(pSPI_Handle->RxLen){
+			*pSPI_Handle->pRxBuffer++ = (uint8_t)(frame >> 8);
+			pSPI_Handle->RxLen--;
+		}
+	}else{// Frame Size = 8
+		*pSPI_Handle->pRxBuffer++ = (uint8_t)pSPIx->DR;
+		pSPI_Handle->RxLen--;
+	}
+
+	/** Half-duplex master: the last frame is on the wire, stop the clock after it */
+	if(pSPI_Handle->RxLen && pSPI_Handle->RxLen <= ((pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)) ? 2U : 1U)
+			&& spi_is_hd_master_rx(pSPIx)){
+		spi_hd_stop_clock(pSPIx, DWT->CYCCNT, pSPI_Handle->HdSckCycles);
+	}
+
+	if(pSPI_Handle->RxLen == 0){
+		pSPI_Handle->pRxBuffer = NULL;
+		if(pSPIx->CR1 & (1U << SPI_CR1_CRCEN_Pos)){
+			return; /** Keep RXNEIE for the CRC frame */
+		}
+		/** Close the reception */
+		pSPIx->CR2 &= ~((1 << SPI_CR2_RXNEIE_Pos) | (1 << SPI_CR2_ERRIE_Pos));
+		pSPI_Handle->RxState = SPI_STATE_READY;
+		spi_app_event(pSPI_Handle, SPI_EVENT_RX_CMPLT);
+	}
+}
+
+ISR_RAMFUNC static void spi_ovr_interrupt_handle(SPIx_Handle_t *pSPI_Handle){
+	/** Clear OVR by reading DR followed by SR */
+	(void)pSPI_Handle->pSPIx->DR;
+	(void)pSPI_Handle->pSPIx->SR;
+	spi_app_event(pSPI_Handle, SPI_EVENT_OVR_ERR);
+}
+
+void SPIx_IRQ_Config(uint8_t IRQNumber, uint8_t IRQPriority){
+	nvic_set_priority(IRQNumber, IRQPriority);
+}
+
+void SPIx_IRQ_Control(uint8_t IRQNumber, uint8_t EN_DI){
+	if(EN_DI == ENABLE){
+		nvic_enable_irq(IRQNumber);
+	}else{
+		nvic_disable_irq(IRQNumber);
+	}
+}
+
+/** Fixed source/sink used when one direction of the exchange is not wanted */
+static uint16_t spi_dma_dummy_tx = 0xFFFF;
+static uint16_t spi_dma_dummy_rx;
+
+static void spi_dma_handle(SPIx_Handle_t *pSPI_Handle, uint8_t tx, DMAx_Handle_t *pDMA_Handle){
+	const spi_instance_t *pMap = spi_instance_lookup(pSPI_Handle->pSPIx);
+	pDMA_Handle->pDMAx = pMap->pDMAx;
+	pDMA_Handle->STREAM = tx ? pMap->TxStream : pMap->RxStream;
+	pDMA_Handle->DMA_CONFIG.DMA_CHANNEL = pMap->Channel;
+	pDMA_Handle->DMA_CONFIG.DMA_DIRECTION = tx ? DMA_DIR_MEM_TO_PERIPH : DMA_DIR_PERIPH_TO_MEM;
+	pDMA_Handle->DMA_CONFIG.DMA_DATA_SIZE =
+			(pSPI_Handle->pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)) ? DMA_DATA_SIZE_HALF_WORD : DMA_DATA_SIZE_BYTE;
+	pDMA_Handle->DMA_CONFIG.DMA_MEM_INC = DMA_MEM_INC_EN;
+	pDMA_Handle->DMA_CONFIG.DMA_CIRCULAR = DMA_CIRC_DI;
+	pDMA_Handle->DMA_CONFIG.DMA_PRIORITY = DMA_PRIORITY_HIGH;
+}
+
+/**
+ * NDTR counts frames in 16 bits and a 16-bit frame moves two bytes, so a
+ * length that does not fit either would be silently truncated by the stream.
+ */
+static uint8_t spi_dma_len_ok(const SPIx_RegDef_t *pSPIx, uint32_t Len){
+	if(pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)){
+		return ((Len & 1U) == 0U) && ((Len / 2U) <= 0xFFFFU);
+	}
+	return Len <= 0xFFFFU;
+}
+
+/**
+ * Common start sequence. RX is armed before TX so the first received frame
+ * always finds its stream ready (RM0090 "Communication using DMA").
+ */
+static void spi_dma_start(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTx, uint8_t *pRx,
+		uint32_t Len, uint8_t use_rx, uint8_t xfer){
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	uint16_t frames = (uint16_t)((pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)) ? (Len / 2) : Len);
+	DMAx_Handle_t hdma;
+
+	pSPI_Handle->DmaXfer = xfer;
+	/** With CRCEN the SPI sends/checks the CRC after NDTR frames on its own */
+	SPIx_ResetCRC(pSPIx);
+
+	if(use_rx){
+		pSPI_Handle->RxState = SPI_STATE_BUSY_IN_RX;
+		/** Drop a stale frame and OVR before the stream starts reading DR */
+		(void)pSPIx->DR;
+		(void)pSPIx->SR;
+		spi_dma_handle(pSPI_Handle, 0, &hdma);
+		hdma.DMA_CONFIG.DMA_MEM_INC = pRx ? DMA_MEM_INC_EN : DMA_MEM_INC_DI;
+		DMAx_Init(&hdma);
+		DMAx_Start(&hdma, (uint32_t)(uintptr_t)&pSPIx->DR,
+				(uint32_t)(uintptr_t)(pRx ? (void*)pRx : (void*)&spi_dma_dummy_rx), frames,
+				DMA_FLAG_TCIF | DMA_FLAG_HTIF | DMA_FLAG_TEIF);
+		pSPIx->CR2 |= (1 << SPI_CR2_RXDMAEN_Pos);
+	}
+
+	if(use_rx && xfer != SPI_DMA_XFER_TXRX && !spi_is_full_duplex_master(pSPIx)){
+		return; /** Slave, RX-only or half-duplex receive: no clock to generate */
+	}
+	pSPI_Handle->TxState = SPI_STATE_BUSY_IN_TX;
+	spi_dma_handle(pSPI_Handle, 1, &hdma);
+	hdma.DMA_CONFIG.DMA_MEM_INC = pTx ? DMA_MEM_INC_EN : DMA_MEM_INC_DI;
+	DMAx_Init(&hdma);
+	DMAx_Start(&hdma, (uint32_t)(uintptr_t)&pSPIx->DR,
+			(uint32_t)(uintptr_t)(pTx ? (const void*)pTx : (const void*)&spi_dma_dummy_tx), frames,
+			DMA_FLAG_TCIF | DMA_FLAG_TEIF | ((xfer == SPI_DMA_XFER_TX) ? DMA_FLAG_HTIF : 0));
+	pSPIx->CR2 |= (1 << SPI_CR2_TXDMAEN_Pos);
+}
+
+uint8_t SPIx_Transmit_DMA(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer, uint32_t Len){
+	uint8_t state = pSPI_Handle->TxState;
+	if(state != SPI_STATE_READY){
+		return state;
+	}
+	if(Len == 0 || !spi_dma_len_ok(pSPI_Handle->pSPIx, Len) || spi_instance_lookup(pSPI_Handle->pSPIx) == NULL){
+		return SPI_NOT_STARTED;
+	}
+	spi_dma_start(pSPI_Handle, pTxBuffer, NULL, Len, 0, SPI_DMA_XFER_TX);
+	return state;
+}
+
+uint8_t SPIx_Receive_DMA(SPIx_Handle_t *pSPI_Handle, uint8_t *pRxBuffer, uint32_t Len){
+	uint8_t state = pSPI_Handle->RxState;
+	if(state != SPI_STATE_READY || pSPI_Handle->TxState != SPI_STATE_READY){
+		return (state != SPI_STATE_READY) ? state : pSPI_Handle->TxState;
+	}
+	if(Len == 0 || !spi_dma_len_ok(pSPI_Handle->pSPIx, Len) || spi_instance_lookup(pSPI_Handle->pSPIx) == NULL){
+		return SPI_NOT_STARTED;
+	}
+	spi_dma_start(pSPI_Handle, NULL, pRxBuffer, Len, 1, SPI_DMA_XFER_RX);
+	return state;
+}
+
+uint8_t SPIx_TransmitReceive_DMA(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer,
+		uint8_t *pRxBuffer, uint32_t Len){
+	if(pSPI_Handle->TxState != SPI_STATE_READY){
+		return pSPI_Handle->TxState;
+	}
+	if(pSPI_Handle->RxState != SPI_STATE_READY){
+		return pSPI_Handle->RxState;
+	}
+	if(Len == 0 || !spi_dma_len_ok(pSPI_Handle->pSPIx, Len) || spi_instance_lookup(pSPI_Handle->pSPIx) == NULL){
+		return SPI_NOT_STARTED;
+	}
+	spi_dma_start(pSPI_Handle, pTxBuffer, pRxBuffer, Len, 1, SPI_DMA_XFER_TXRX);
+	return SPI_STATE_READY;
+}
+
+static void spi_hd_start_rx_dma(SPIx_Handle_t *pSPI_Handle){
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	uint8_t *pRx = pSPI_Handle->pHdRxBuffer;
+	uint32_t Len = pSPI_Handle->HdRxLen;
+
+	pSPI_Handle->pHdRxBuffer = NULL;
+	pSPI_Handle->HdRxLen = 0;
+	spi_hd_turnaround(pSPIx);
+	spi_dma_start(pSPI_Handle, NULL, pRx, Len, 1, SPI_DMA_XFER_HD);
+	PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
+}
+
+uint8_t SPIx_HalfDuplex_TransmitReceive_DMA(SPIx_Handle_t *pSPI_Handle, const uint8_t *pTxBuffer,
+		uint32_t TxLen, uint8_t *pRxBuffer, uint32_t RxLen){
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	if(pSPI_Handle->TxState != SPI_STATE_READY){
+		return pSPI_Handle->TxState;
+	}
+	if(pSPI_Handle->RxState != SPI_STATE_READY){
+		return pSPI_Handle->RxState;
+	}
+	if((TxLen == 0 && RxLen == 0) || !spi_dma_len_ok(pSPIx, TxLen) || !spi_dma_len_ok(pSPIx, RxLen)
+			|| pSPI_Handle->SPI_CONFIG.SPI_BUS_MODE != SPI_BUS_MODE_HALF_DUPLEX
+			|| spi_instance_lookup(pSPIx) == NULL){
+		return SPI_NOT_STARTED;
+	}
+	pSPI_Handle->pHdRxBuffer = pRxBuffer;
+	pSPI_Handle->HdRxLen = RxLen;
+	if(TxLen == 0){
+		spi_hd_start_rx_dma(pSPI_Handle);
+		return SPI_STATE_READY;
+	}
+	SPIx_HalfDuplex_SetDirection(pSPIx, SPI_HD_DIR_TX);
+	PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
+	spi_dma_start(pSPI_Handle, pTxBuffer, NULL, TxLen, 0, SPI_DMA_XFER_HD);
+	return SPI_STATE_READY;
+}
+
+void SPIx_DMA_IRQ_Config(SPIx_Handle_t *pSPI_Handle, uint8_t IRQPriority){
+	const spi_instance_t *pMap = spi_instance_lookup(pSPI_Handle->pSPIx);
+	if(pMap == NULL){
+		return;
+	}
+	uint8_t tx_irq = DMAx_GetIRQNumber(pMap->pDMAx, pMap->TxStream);
+	uint8_t rx_irq = DMAx_GetIRQNumber(pMap->pDMAx, pMap->RxStream);
+	SPIx_IRQ_Config(tx_irq, IRQPriority);
+	SPIx_IRQ_Config(rx_irq, IRQPriority);
+	SPIx_IRQ_Control(tx_irq, ENABLE);
+	SPIx_IRQ_Control(rx_irq, ENABLE);
+}
+
+static void spi_dma_abort(SPIx_Handle_t *pSPI_Handle){
+	DMAx_Handle_t hdma;
+	pSPI_Handle->pSPIx->CR2 &= ~((1 << SPI_CR2_TXDMAEN_Pos) | (1 << SPI_CR2_RXDMAEN_Pos));
+	spi_dma_handle(pSPI_Handle, 1, &hdma);
+	DMAx_Stop(&hdma);
+	spi_dma_handle(pSPI_Handle, 0, &hdma);
+	DMAx_Stop(&hdma);
+	pSPI_Handle->TxState = SPI_STATE_READY;
+	pSPI_Handle->RxState = SPI_STATE_READY;
+	pSPI_Handle->DmaXfer = SPI_DMA_XFER_NONE;
+	spi_app_event(pSPI_Handle, SPI_EVENT_DMA_ERR);
+}
+
+void SPIx_DMA_TX_IRQHandling(SPIx_Handle_t *pSPI_Handle){
+	const spi_instance_t *pMap = spi_instance_lookup(pSPI_Handle->pSPIx);
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	uint8_t flags = DMAx_GetFlags(pMap->pDMAx, pMap->TxStream);
+	DMAx_ClearFlags(pMap->pDMAx, pMap->TxStream, flags);
+
+	if(flags & DMA_FLAG_TEIF){
+		spi_dma_abort(pSPI_Handle);
+		return;
+	}
+	if((flags & DMA_FLAG_HTIF) && pSPI_Handle->DmaXfer == SPI_DMA_XFER_TX){
+		spi_app_event(pSPI_Handle, SPI_EVENT_TX_HALF_CMPLT);
+	}
+	if(flags & DMA_FLAG_TCIF){
+		/** Last frame is in DR, the SPI keeps shifting it out on its own */
+		pSPIx->CR2 &= ~(1 << SPI_CR2_TXDMAEN_Pos);
+		pSPI_Handle->TxState = SPI_STATE_READY;
+		if(pSPI_Handle->DmaXfer == SPI_DMA_XFER_HD && pSPI_Handle->HdRxLen){
+			/** Half-duplex: the response follows the command */
+			spi_hd_start_rx_dma(pSPI_Handle);
+		}else if(pSPI_Handle->DmaXfer == SPI_DMA_XFER_TX || pSPI_Handle->DmaXfer == SPI_DMA_XFER_HD){
+			pSPI_Handle->DmaXfer = SPI_DMA_XFER_NONE;
+			/** TX only: the unread frames raised OVR, clear it (read DR then SR) */
+			(void)pSPIx->DR;
+			(void)pSPIx->SR;
+			spi_app_event(pSPI_Handle, SPI_EVENT_TX_CMPLT);
+		}
+	}
+}
+
+void SPIx_DMA_RX_IRQHandling(SPIx_Handle_t *pSPI_Handle){
+	const spi_instance_t *pMap = spi_instance_lookup(pSPI_Handle->pSPIx);
+	uint8_t flags = DMAx_GetFlags(pMap->pDMAx, pMap->RxStream);
+	DMAx_ClearFlags(pMap->pDMAx, pMap->RxStream, flags);
+
+	if(flags & DMA_FLAG_TEIF){
+		spi_dma_abort(pSPI_Handle);
+		return;
+	}
+	if(flags & DMA_FLAG_HTIF){
+		spi_app_event(pSPI_Handle, SPI_EVENT_RX_HALF_CMPLT);
+	}
+	if(flags & DMA_FLAG_TCIF){
+		SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+		uint8_t xfer = pSPI_Handle->DmaXfer;
+		pSPIx->CR2 &= ~(1 << SPI_CR2_RXDMAEN_Pos);
+		if(xfer == SPI_DMA_XFER_TXRX){
+			/** Every frame came back so TX is done as well. Retire the TX stream
+			 *  here: its IRQ may be served after this one (lower NVIC number wins)
+			 *  and must not touch a transfer started from the callback below. */
+			pSPIx->CR2 &= ~(1 << SPI_CR2_TXDMAEN_Pos);
+			DMAx_ClearFlags(pMap->pDMAx, pMap->TxStream, DMA_FLAG_ALL);
+			pSPI_Handle->TxState = SPI_STATE_READY;
+		}
+		if(xfer == SPI_DMA_XFER_HD && (pSPIx->CR1 & (1U << SPI_CR1_MSTR_Pos))){
+			/** Stop the clock, drain the frames clocked past NDTR */
+			PERIPH_BIT_CLR(pSPIx->CR1, SPI_CR1_SPE_Pos);
+			while(pSPIx->SR & (1 << SPI_SR_BSY_Pos));
+			(void)pSPIx->DR;
+			(void)pSPIx->SR;
+		}
+		if(pSPIx->CR1 & (1U << SPI_CR1_CRCEN_Pos)){
+			/** The CRC frame is not counted in NDTR, read it by hand (one frame time) */
+			while(!(pSPIx->SR & (1 << SPI_SR_RXNE_Pos)));
+			(void)pSPIx->DR;
+			if(spi_crc_error_clear(pSPIx)){
+				spi_app_event(pSPI_Handle, SPI_EVENT_CRC_ERR);
+			}
+		}
+		pSPI_Handle->RxState = SPI_STATE_READY;
+		pSPI_Handle->DmaXfer = SPI_DMA_XFER_NONE;
+		spi_app_event(pSPI_Handle, (xfer == SPI_DMA_XFER_TXRX) ? SPI_EVENT_TXRX_CMPLT : SPI_EVENT_RX_CMPLT);
+	}
+}
+
+uint8_t SPIx_SlaveRing_Start(SPIx_SlaveRing_t *pRing, SPIx_Handle_t *pSPI_Handle, uint8_t *pBuffer,
+		uint16_t Size, const uint8_t *pTxBuffer, uint16_t TxLen){
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	uint8_t frame = (pSPIx->CR1 & (1U << SPI_CR1_DFF_Pos)) ? 2 : 1;
+	DMAx_Handle_t hdma;
+
+	if(pSPI_Handle->TxState != SPI_STATE_READY){
+		return pSPI_Handle->TxState;
+	}
+	if(pSPI_Handle->RxState != SPI_STATE_READY){
+		return pSPI_Handle->RxState;
+	}
+	/** HT/TC must fall on frame boundaries */
+	if(Size == 0 || (Size % (2U * frame)) || (pTxBuffer && (TxLen == 0 || (TxLen % frame)))
+			|| spi_instance_lookup(pSPIx) == NULL){
+		return SPI_NOT_STARTED;
+	}
+
+	pRing->pSPI_Handle = pSPI_Handle;
+	pRing->pBuffer = pBuffer;
+	pRing->Size = Size;
+	pRing->FrameBytes = frame;
+	pRing->WriteTotal = 0;
+	pRing->ReadTotal = 0;
+	pRing->OverrunCount = 0;
+	pRing->UnderrunCount = 0;
+	pRing->RingOverflowCount = 0;
+	pRing->FrameErrorCount = 0;
+
+	pSPI_Handle->TxState = SPI_STATE_BUSY_IN_TX;
+	pSPI_Handle->RxState = SPI_STATE_BUSY_IN_RX;
+	pSPI_Handle->DmaXfer = SPI_DMA_XFER_RING;
+
+	/** 1. RX stream, circular over the ring */
+	(void)pSPIx->DR;
+	(void)pSPIx->SR;
+	spi_dma_handle(pSPI_Handle, 0, &hdma);
+	hdma.DMA_CONFIG.DMA_CIRCULAR = DMA_CIRC_EN;
+	hdma.DMA_CONFIG.DMA_PRIORITY = DMA_PRIORITY_VERY_HIGH;
+	DMAx_Init(&hdma);
+	DMAx_Start(&hdma, (uint32_t)(uintptr_t)&pSPIx->DR, (uint32_t)(uintptr_t)pBuffer,
+			(uint16_t)(Size / frame), DMA_FLAG_HTIF | DMA_FLAG_TCIF | DMA_FLAG_TEIF);
+	pSPIx->CR2 |= (1 << SPI_CR2_RXDMAEN_Pos);
+
+	/** 2. TX stream, circular over the response so TXE is refilled before the master clocks */
+	spi_dma_handle(pSPI_Handle, 1, &hdma);
+	hdma.DMA_CONFIG.DMA_CIRCULAR = DMA_CIRC_EN;
+	hdma.DMA_CONFIG.DMA_MEM_INC = pTxBuffer ? DMA_MEM_INC_EN : DMA_MEM_INC_DI;
+	DMAx_Init(&hdma);
+	DMAx_Start(&hdma, (uint32_t)(uintptr_t)&pSPIx->DR,
+			(uint32_t)(uintptr_t)(pTxBuffer ? (const void*)pTxBuffer : (const void*)&spi_dma_dummy_tx),
+			(uint16_t)(pTxBuffer ? (TxLen / frame) : 1), DMA_FLAG_TEIF);
+	pSPIx->CR2 |= (1 << SPI_CR2_TXDMAEN_Pos) | (1 << SPI_CR2_ERRIE_Pos);
+
+	/** 3. Only now answer the master */
+	PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
+	return SPI_STATE_READY;
+}
+
+void SPIx_SlaveRing_Stop(SPIx_SlaveRing_t *pRing){
+	SPIx_Handle_t *pSPI_Handle = pRing->pSPI_Handle;
+	SPIx_RegDef_t *pSPIx = pSPI_Handle->pSPIx;
+	DMAx_Handle_t hdma;
+
+	PERIPH_BIT_CLR(pSPIx->CR1, SPI_CR1_SPE_Pos);
+	pSPIx->CR2 &= ~((1 << SPI_CR2_TXDMAEN_Pos) | (1 << SPI_CR2_RXDMAEN_Pos) | (1 << SPI_CR2_ERRIE_Pos));
+	spi_dma_handle(pSPI_Handle, 1, &hdma);
+	DMAx_Stop(&hdma);
+	spi_dma_handle(pSPI_Handle, 0, &hdma);
+	DMAx_Stop(&hdma);
+	pSPI_Handle->TxState = SPI_STATE_READY;
+	pSPI_Handle->RxState = SPI_STATE_READY;
+	pSPI_Handle->DmaXfer = SPI_DMA_XFER_NONE;
+}
+
+/*
+ * Bytes received so far. WriteTotal only moves at half-ring boundaries, the
+ * part written since then comes from NDTR. Correct as long as the IRQ latency
+ * stays below half a ring.
+ */
+static uint32_t spi_ring_written(SPIx_SlaveRing_t *pRing){
+	const spi_instance_t *pMap = spi_instance_lookup(pRing->pSPI_Handle->pSPIx);
+	DMA_Stream_RegDef_t *pStream = &pMap->pDMAx->STREAM[pMap->RxStream];
+	uint32_t base, pos;
+
+	do{
+		base = pRing->WriteTotal;
+		pos = pRing->Size - (pStream->NDTR * pRing->FrameBytes);
+	}while(base != pRing->WriteTotal);
+
+	return base + ((pos + pRing->Size - (base % pRing->Size)) % pRing->Size);
+}
+
+uint16_t SPIx_SlaveRing_Peek(SPIx_SlaveRing_t *pRing, const uint8_t **ppData){
+	uint32_t written = spi_ring_written(pRing);
+	uint32_t avail = written - pRing->ReadTotal;
+
+	if(avail > pRing->Size){
+		/** The oldest unread bytes are already overwritten */
+		pRing->RingOverflowCount++;
+		pRing->ReadTotal = written;
+		return 0;
+	}
+	uint32_t idx = pRing->ReadTotal % pRing->Size;
+	uint32_t span = pRing->Size - idx;
+	*ppData = &pRing->pBuffer[idx];
+	return (uint16_t)((avail < span) ? avail : span);
+}
+
+void SPIx_SlaveRing_Consume(SPIx_SlaveRing_t *pRing, uint16_t Len){
+	pRing->ReadTotal += Len;
+}
+
+uint32_t SPIx_SlaveRing_Available(SPIx_SlaveRing_t *pRing){
+	uint32_t avail = spi_ring_written(pRing) - pRing->ReadTotal;
+	return (avail > pRing->Size) ? pRing->Size : avail;
+}
+
+void SPIx_SlaveRing_IRQHandling(SPIx_SlaveRing_t *pRing){
+	SPIx_RegDef_t *pSPIx = pRing->pSPI_Handle->pSPIx;
+	uint32_t sr = pSPIx->SR;
+
+	if(sr & (1 << SPI_SR_OVR_Pos)){
+		/** Clear sequence: read DR then SR. The frame in DR is already lost. */
+		(void)pSPIx->DR;
+		(void)pSPIx->SR;
+		pRing->OverrunCount++;
+	}
+	if(sr & (1 << SPI_SR_UDR_Pos)){
+		/** Cleared by the SR read above */
+		pRing->UnderrunCount++;
+	}
+	if(sr & (1 << SPI_SR_FRE_Pos)){
+		/** Cleared by the SR read above */
+		pRing->FrameErrorCount++;
+	}
+}
+
+void SPIx_SlaveRing_DMA_IRQHandling(SPIx_SlaveRing_t *pRing){
+	const spi_instance_t *pMap = spi_instance_lookup(pRing->pSPI_Handle->pSPIx);
+	uint8_t rx = DMAx_GetFlags(pMap->pDMAx, pMap->RxStream);
+	uint8_t tx = DMAx_GetFlags(pMap->pDMAx, pMap->TxStream);
+	DMAx_ClearFlags(pMap->pDMAx, pMap->RxStream, rx);
+	DMAx_ClearFlags(pMap->pDMAx, pMap->TxStream, tx);
+
+	if((rx | tx) & DMA_FLAG_TEIF){
+		SPIx_SlaveRing_Stop(pRing);
+		spi_app_event(pRing->pSPI_Handle, SPI_EVENT_DMA_ERR);
+		return;
+	}
+	if(rx & DMA_FLAG_HTIF){
+		pRing->WriteTotal += pRing->Size / 2;
+	}
+	if(rx & DMA_FLAG_TCIF){
+		pRing->WriteTotal += pRing->Size / 2;
+	}
+}
@@ -0,0 +1,243 @@
+/**
+ ******************************************************************************
+ * @file    stm32f407xx_spi_bus.c
+ * @author  Yuvraj Singh Rathore
+ * @version 1.0
+ * @date    05-Dec-2025
+ * @brief   Multi-device SPI bus layer source file for STM32F407xx MCU.
+ *
+ * @details
+ * Serialises transactions of several devices on one SPI master:
+ *
+ *  - Fixed-size FIFO of transactions per bus, filled from thread or IRQ context
+ *  - Chip-select asserted/deasserted by the bus around every transaction
+ *  - Per-device register image, loaded only when it differs from the active one
+ *  - Next transaction started from the DMA completion interrupt, so queued
+ *    work runs back to back without the application polling
+ *  - Device dividers recompiled from an RCC hook after every clock change
+ *
+ * @section SPI_BUS_API_Summary SPI Bus API Summary
+ *
+ * - spi_bus_init()        : Attach the bus to an SPI handle
+ * - spi_bus_device_init() : Configure the chip-select pin of a device
+ * - spi_bus_submit()      : Queue a transaction
+ * - spi_bus_is_idle()     : Check for queue drained
+ *
+ * @see stm32f407xx_spi_bus.h
+ ******************************************************************************
+ */
+
+#include "stm32f407xx_spi_bus.h"
+
+static void spi_bus_configure(SPI_Bus_t *pBus, const SPI_BusDevice_t *pDevice){
+	const SPI_BusDevice_t *pActive = pBus->pActiveDevice;
+
+	/** Devices with identical settings share the image, nothing to write */
+	if(pActive == NULL || pActive->Image.CR1 != pDevice->Image.CR1
+			|| pActive->Image.CR2 != pDevice->Image.CR2 || pActive->Image.CRCPR != pDevice->Image.CRCPR){
+		SPIx_ApplyConfig(pBus->pSPI_Handle->pSPIx, &pDevice->Image);
+	}
+	pBus->pActiveDevice = pDevice;
+}
+
+/*
+ * Release the device of the head transaction, drop it from the queue and
+ * report Status to its owner.
+ */
+static void spi_bus_retire(SPI_Bus_t *pBus, uint8_t Status){
+	SPI_BusTransaction_t txn = pBus->Queue[pBus->Head];
+
+	gpio_write_pin(txn.pDevice->pCSPort, txn.pDevice->CSPin, SET);
+	pBus->Head = (uint8_t)((pBus->Head + 1) % SPI_BUS_QUEUE_LEN);
+	pBus->Count--;
+	pBus->Busy = 0;
+
+	if(txn.pfDone){
+		txn.pfDone(&txn, Status);
+	}
+}
+
+/*
+ * Start the transaction at the head of the queue if the bus is free.
+ * Called with interrupts masked or from the DMA completion interrupt.
+ * A transaction the driver does not start (SPI_NOT_STARTED, or a busy
+ * state if the handle is used outside the bus) is completed with
+ * SPI_ERROR_NOT_STARTED and the next one is tried, so a refused
+ * transaction does not hold up the ones queued behind it.
+ */
+static void spi_bus_kick(SPI_Bus_t *pBus){
+	SPIx_RegDef_t *pSPIx = pBus->pSPI_Handle->pSPIx;
+
+	while(!pBus->Paused && !pBus->Busy && pBus->Count != 0){
+		SPI_BusTransaction_t *pTxn = &pBus->Queue[pBus->Head];
+
+		pBus->Busy = 1;
+		pBus->Status = SPI_ERROR_NONE;
+		spi_bus_configure(pBus, pTxn->pDevice);
+		PERIPH_BIT_SET(pSPIx->CR1, SPI_CR1_SPE_Pos);
+
+		gpio_write_pin(pTxn->pDevice->pCSPort, pTxn->pDevice->CSPin, RESET);
+		uint8_t state = SPIx_TransmitReceive_DMA(pBus->pSPI_Handle, pTxn->pTxBuffer, pTxn->pRxBuffer, pTxn->Len);
+		if(state == SPI_STATE_READY){
+			return; /** Started: TXRX_CMPLT or DMA_ERR retires it */
+		}
+		/** Nothing was clocked: release the device and stop the peripheral */
+		PERIPH_BIT_CLR(pSPIx->CR1, SPI_CR1_SPE_Pos);
+		spi_bus_retire(pBus, SPI_ERROR_NOT_STARTED);
+	}
+}
+
+static void spi_bus_complete(SPI_Bus_t *pBus){
+	SPIx_RegDef_t *pSPIx = pBus->pSPI_Handle->pSPIx;
+
+	/** Last frame fully clocked out before the device is released */
+	while(pSPIx->SR & (1U << SPI_SR_BSY_Pos));
+	spi_bus_retire(pBus, pBus->Status);
+	spi_bus_kick(pBus);
+}
+
+static void spi_bus_event(SPIx_Handle_t *pSPI_Handle, uint8_t AppEvent){
+	SPI_Bus_t *pBus = (SPI_Bus_t*)pSPI_Handle->pAppContext;
+
+	if(AppEvent == SPI_EVENT_CRC_ERR){
+		pBus->Status = SPI_ERROR_CRC;
+	}else if(AppEvent == SPI_EVENT_DMA_ERR){
+		/** The driver aborted both streams, no TXRX_CMPLT follows */
+		pBus->Status = SPI_ERROR_DMA;
+		spi_bus_complete(pBus);
+	}else if(AppEvent == SPI_EVENT_TXRX_CMPLT){
+		spi_bus_complete(pBus);
+	}
+}
+
+/*
+ * Register image of a device: handle settings with the device's own mode,
+ * baud and frame. The divider follows the current APB clock when the device
+ * gives an SCK limit.
+ */
+static void spi_bus_compile(SPI_Bus_t *pBus, SPI_BusDevice_t *pDevice){
+	SPIx_Config_t config = pBus->pSPI_Handle->SPI_CONFIG;
+
+	config.SPI_CLOCK_SPEED = pDevice->MaxSckHz
+			? SPIx_ComputeClockSpeed(pBus->pSPI_Handle->pSPIx, pDevice->MaxSckHz)
+			: pDevice->SPI_CLOCK_SPEED;
+	config.SPI_CPOL = pDevice->SPI_CPOL;
+	config.SPI_CPHA = pDevice->SPI_CPHA;
+	config.SPI_FRAME_SIZE = pDevice->SPI_FRAME_SIZE;
+	config.SPI_BIT_ORDER = pDevice->SPI_BIT_ORDER;
+	SPIx_CompileConfig(&config, &pDevice->Image);
+}
+
+/*
+ * The images carry BR, so a clock change goes through the bus: refuse it
+ * while a transaction runs, otherwise hold the queue, recompile every
+ * image after the change and restart the queue. An aborted change only
+ * restarts the queue.
+ */
+static uint8_t spi_bus_clock_hook(uint8_t Phase, void *pContext){
+	SPI_Bus_t *pBus = (SPI_Bus_t*)pContext;
+	uint32_t primask;
+
+	if(Phase == RCC_CLOCK_CHANGE_PRE){
+		primask = nvic_irq_save();
+		if(pBus->Busy){
+			nvic_irq_restore(primask);
+			return RCC_ERR_BUSY;
+		}
+		pBus->Paused = 1; /** Submissions queue up, nothing is kicked until POST/ABORT */
+		nvic_irq_restore(primask);
+		return RCC_OK;
+	}
+	if(Phase == RCC_CLOCK_CHANGE_POST){
+		for(uint8_t i = 0; i < pBus->DeviceCount; i++){
+			spi_bus_compile(pBus, pBus->pDevices[i]);
+		}
+	}
+	primask = nvic_irq_save();
+	if(Phase == RCC_CLOCK_CHANGE_POST){
+		pBus->pActiveDevice = NULL; /** Force a reload on the next transaction */
+	}
+	pBus->Paused = 0;
+	spi_bus_kick(pBus);
+	nvic_irq_restore(primask);
+	return RCC_OK;
+}
+
+uint8_t spi_bus_init(SPI_Bus_t *pBus, SPIx_Handle_t *pSPI_Handle){
+	pBus->pSPI_Handle = pSPI_Handle;
+	pBus->Head = 0;
+	pBus->Count = 0;
+	pBus->Busy = 0;
+	pBus->Status = SPI_ERROR_NONE;
+	pBus->pActiveDevice = NULL;
+	pBus->DeviceCount = 0;
+	pBus->Paused = 0;
+
+	pSPI_Handle->pAppContext = pBus;
+	pSPI_Handle->AppEventCallback = spi_bus_event;
+	/** A hook from SPIx_RegisterClockHook() would fight the per-device images */
+	pSPI_Handle->BusOwned = 1;
+
+	if(rcc_clock_hook_register(spi_bus_clock_hook, pBus) != RCC_OK){
+		return SPI_BUS_ERR_HOOK_FULL;
+	}
+	return SPI_BUS_OK;
+}
+
+uint8_t spi_bus_device_init(SPI_Bus_t *pBus, SPI_BusDevice_t *pDevice){
+	GPIOx_Handle_t cs;
+	uint8_t i;
+
+	/** 1. Device list, walked by the clock hook */
+	for(i = 0; i < pBus->DeviceCount && pBus->pDevices[i] != pDevice; i++);
+	if(i == pBus->DeviceCount){
+		if(pBus->DeviceCount == SPI_BUS_MAX_DEVICES){
+			return SPI_BUS_ERR_DEVICE_FULL;
+		}
+		pBus->pDevices[pBus->DeviceCount++] = pDevice;
+	}
+
+	/** 2. Register image */
+	spi_bus_compile(pBus, pDevice);
+	if(pBus->pActiveDevice == pDevice){
+		pBus->pActiveDevice = NULL; /** Force a reload on the next transaction */
+	}
+
+	/** 3. Chip-select, deasserted */
+	cs.pGPIOx = pDevice->pCSPort;
+	cs.GPIO_CONFIG.GPIO_PIN_NUMBER = pDevice->CSPin;
+	cs.GPIO_CONFIG.GPIO_MODE = GPIO_MODE_OUTPUT;
+	cs.GPIO_CONFIG.GPIO_OP_TYPE = GPIO_OP_TYPE_PP;
+	cs.GPIO_CONFIG.GPIO_PU_PD = GPIO_PU_PD_NONE;
+	cs.GPIO_CONFIG.GPIO_SPEED = GPIO_SPEED_HIGH;
+	cs.GPIO_CONFIG.GPIO_ALT_FUNC = 0;
+	gpio_pin_init(&cs);
+	gpio_write_pin(pDevice->pCSPort, pDevice->CSPin, SET);
+	return SPI_BUS_OK;
+}
+
+uint8_t spi_bus_submit(SPI_Bus_t *pBus, const SPI_BusTransaction_t *pTransaction){
+	const SPI_BusDevice_t *pDevice = pTransaction->pDevice;
+	uint32_t frame = (pDevice && pDevice->SPI_FRAME_SIZE == SPI_FRAME_SIZE_16_BITS) ? 2 : 1;
+	if(pDevice == NULL || pTransaction->Len == 0 || (pTransaction->Len % frame)
+			|| (pTransaction->Len / frame) > 0xFFFFU){
+		return SPI_BUS_ERR_PARAM;
+	}
+
+	/** PRIMASK nests when a completion callback submits */
+	uint32_t primask = nvic_irq_save();
+	if(pBus->Count == SPI_BUS_QUEUE_LEN){
+		nvic_irq_restore(primask);
+		return SPI_BUS_ERR_QUEUE_FULL;
+	}
+	pBus->Queue[(pBus->Head + pBus->Count) % SPI_BUS_QUEUE_LEN] = *pTransaction;
+	pBus->Count++;
+	spi_bus_kick(pBus);
+	nvic_irq_restore(primask);
+
+	return SPI_BUS_OK;
+}
+
+uint8_t spi_bus_is_idle(SPI_Bus_t *pBus){
+	return (pBus->Count == 0) ? 1 : 0;
+}